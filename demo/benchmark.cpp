@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <action.hpp>
+#include <environment.hpp>
+#include <parameters.hpp>
+#include <random.hpp>
+#include <go_straight.hpp>
+#include <mcts/mcts.hpp>
+#include <rollout_engine.hpp>
+#include <rollout_batch.hpp>
+#include <state.hpp>
+
+/**
+ * @brief Rollout benchmark
+ *
+ * Time the given number of rollouts of the policy from the initial state of the
+ * configuration and print the throughput.
+ * @param {const parameters &} p; parameters
+ * @param {const std::string &} name; name of the policy
+ * @param {unsigned} nb_rollouts; number of rollouts
+ */
+template <class PL>
+void rollout_benchmark(const parameters &p, const std::string &name, unsigned nb_rollouts) {
+    PL policy(p);
+    environment model(p); // same generative model as the tree-search policies
+    model.misstep_probability = p.MODEL_MISSTEP_PROBABILITY;
+    model.state_gaussian_stddev = p.MODEL_STATE_GAUSSIAN_STDDEV;
+    model.is_crash_terminal = true;
+    rollout_engine rollouts(
+        p.DISCOUNT_FACTOR,p.DEFAULT_POLICY_HORIZON,p.IS_MODEL_DYNAMIC,p.ROLLOUT_TRUNCATION_EPSILON);
+    state s0;
+    p.parse_state(s0);
+    unsigned nb_steps = 0;
+    double total_return = 0.;
+    auto start = std::chrono::steady_clock::now();
+    environment mod(model);
+    for(unsigned i=0; i<nb_rollouts; ++i) {
+        if(p.IS_MODEL_DYNAMIC) { // every rollout starts from the initial model
+            mod.rmodel = model.rmodel;
+        }
+        total_return += rollouts.run(s0,policy(s0),mod,policy,nb_steps);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": "
+              << nb_rollouts << " rollouts, "
+              << nb_steps << " steps in " << 1000. * elapsed.count() << "ms, "
+              << nb_steps / elapsed.count() << " steps/s, "
+              << "mean return " << total_return / ((double) nb_rollouts) << std::endl;
+}
+
+/**
+ * @brief Batch rollout benchmark
+ *
+ * Same as 'rollout_benchmark', the rollouts being simulated in lockstep by batches of the
+ * given size (see 'rollout_batch').
+ * @param {const parameters &} p; parameters
+ * @param {const std::string &} name; name of the policy
+ * @param {unsigned} nb_rollouts; number of rollouts
+ * @param {unsigned} batch_size; number of rollouts of a batch
+ */
+template <class PL>
+void batch_rollout_benchmark(const parameters &p, const std::string &name, unsigned nb_rollouts, unsigned batch_size) {
+    PL policy(p);
+    environment model(p);
+    model.misstep_probability = p.MODEL_MISSTEP_PROBABILITY;
+    model.state_gaussian_stddev = p.MODEL_STATE_GAUSSIAN_STDDEV;
+    model.is_crash_terminal = true;
+    rollout_engine rollouts(
+        p.DISCOUNT_FACTOR,p.DEFAULT_POLICY_HORIZON,p.IS_MODEL_DYNAMIC,p.ROLLOUT_TRUNCATION_EPSILON);
+    rollout_batch batch;
+    state s0;
+    p.parse_state(s0);
+    std::vector<environment> models(batch_size,model);
+    std::vector<rollout_request<environment>> requests;
+    unsigned nb_steps = 0;
+    double total_return = 0.;
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned i=0; i<nb_rollouts; i+=batch_size) {
+        requests.clear();
+        for(unsigned k=0; k<batch_size && i+k<nb_rollouts; ++k) {
+            if(p.IS_MODEL_DYNAMIC) { // every rollout starts from the initial model
+                models[k].rmodel = model.rmodel;
+            }
+            requests.push_back(rollout_request<environment>{s0,&policy(s0),&models[k]});
+        }
+        batch.run(rollouts,model,requests,policy,nb_steps);
+        for(auto &rq : requests) {
+            total_return += rq.value;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << " (batches of " << batch_size << "): "
+              << nb_rollouts << " rollouts, "
+              << nb_steps << " steps in " << 1000. * elapsed.count() << "ms, "
+              << nb_steps / elapsed.count() << " steps/s, "
+              << "mean return " << total_return / ((double) nb_rollouts) << std::endl;
+}
+
+/**
+ * @brief Shared tree benchmark
+ *
+ * Time a search of the given number of iterations from the initial state of the
+ * configuration with a tree shared by 1, 2, 4, ... threads, up to 16 threads or the number
+ * of hardware threads if greater, and print the throughput and the speedup with respect
+ * to the sequential search.
+ * @param {const parameters &} p; parameters
+ * @param {unsigned} nb_iterations; number of iterations of a search
+ */
+void shared_tree_benchmark(const parameters &p, unsigned nb_iterations) {
+    parameters sp = p;
+    sp.TREE_SEARCH_BUDGET = nb_iterations;
+    sp.DECISION_TIME_LIMIT = 0;
+    sp.EARLY_STOP_PERIOD = 0;
+    sp.MCTS_STRATEGY_SWITCH = 0;
+    sp.REUSE_TREE = false;
+    sp.PONDER = false;
+    sp.SHARED_TREE = true;
+    state s0;
+    p.parse_state(s0);
+    unsigned max_nb_threads = std::max(16u,std::thread::hardware_concurrency());
+    double sequential_rate = 0.;
+    for(unsigned nb_threads=1; nb_threads<=max_nb_threads; nb_threads*=2) {
+        sp.NB_THREADS = nb_threads;
+        mcts<environment,go_straight> pl(sp);
+        auto start = std::chrono::steady_clock::now();
+        pl.plan(s0);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        double rate = pl.nb_iterations_spent / elapsed.count();
+        if(nb_threads == 1) {
+            sequential_rate = rate;
+        }
+        std::cout << "shared tree (" << nb_threads << " threads): "
+                  << pl.nb_iterations_spent << " iterations in " << 1000. * elapsed.count() << "ms, "
+                  << rate << " iterations/s, "
+                  << "speedup " << rate / sequential_rate << std::endl;
+    }
+}
+
+/**
+ * @brief Main function
+ *
+ * Usage: benchmark [number of rollouts] [number of iterations of the tree searches]
+ */
+int main(int argc, char **argv) {
+    try {
+        srand(time(NULL));
+        unsigned nb_rollouts = (argc > 1) ? std::strtoul(argv[1],nullptr,10) : 10000;
+        unsigned nb_iterations = (argc > 2) ? std::strtoul(argv[2],nullptr,10) : 20000;
+        parameters p("config/main.cfg");
+        rollout_benchmark<go_straight>(p,"go_straight",nb_rollouts);
+        rollout_benchmark<random_policy>(p,"random_policy",nb_rollouts);
+        if(p.ROLLOUT_BATCH_SIZE > 1) {
+            batch_rollout_benchmark<go_straight>(p,"go_straight",nb_rollouts,p.ROLLOUT_BATCH_SIZE);
+            batch_rollout_benchmark<random_policy>(p,"random_policy",nb_rollouts,p.ROLLOUT_BATCH_SIZE);
+        }
+        shared_tree_benchmark(p,nb_iterations);
+    }
+    catch(const std::exception &e) {
+        std::cerr << "Error in main(): standard exception caught: " << e.what() << std::endl;
+    }
+    catch(...) {
+        std::cerr << "Error in main(): unknown exception caught" << std::endl;
+    }
+    return 0;
+}
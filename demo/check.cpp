@@ -0,0 +1,575 @@
+#include <algorithm>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <action.hpp>
+#include <environment.hpp>
+#include <parameters.hpp>
+#include <random.hpp>
+#include <go_straight.hpp>
+#include <rollout_engine.hpp>
+#include <oluct.hpp>
+#include <mcts/mcts.hpp>
+#include <state.hpp>
+#include <utils.hpp>
+
+typedef mcts<environment,go_straight> planner; ///< Planner under check
+
+unsigned nb_failures = 0; ///< Number of failed checks
+
+/**
+ * @brief Check
+ *
+ * Print the result of a check and count the failures.
+ * @param {bool} is_passed; result of the check
+ * @param {const std::string &} name; name of the check
+ */
+void check(bool is_passed, const std::string &name) {
+    std::cout << (is_passed ? "[ OK ] " : "[FAIL] ") << name << std::endl;
+    if(!is_passed) {
+        ++nb_failures;
+    }
+}
+
+/**
+ * @brief Search parameters
+ *
+ * Parameters of config/main.cfg for a sequential search of a static and noiseless model,
+ * every optional feature of the planner being disabled.
+ * @return Return the parameters.
+ */
+parameters search_parameters() {
+    parameters p("config/main.cfg");
+    p.MODEL_MISSTEP_PROBABILITY = 0.;
+    p.MODEL_STATE_GAUSSIAN_STDDEV = 0.;
+    p.IS_MODEL_DYNAMIC = false;
+    p.TREE_SEARCH_BUDGET = 200;
+    p.MAX_TREE_RECORDS = 0;
+    p.DECISION_TIME_LIMIT = 0;
+    p.EARLY_STOP_PERIOD = 0;
+    p.MCTS_STRATEGY_SWITCH = 0;
+    p.PW_COEFFICIENT = 0.;
+    p.DPW_COEFFICIENT = 0.;
+    p.USE_TRANSPOSITION_TABLE = false;
+    p.REUSE_TREE = false;
+    p.PONDER = false;
+    p.NB_THREADS = 1;
+    p.SHARED_TREE = false;
+    p.NB_LEAF_ROLLOUTS = 1;
+    p.ROLLOUT_CACHE_CAPACITY = 0;
+    p.ROLLOUT_BATCH_SIZE = 0;
+    return p;
+}
+
+/**
+ * @brief Index table checks
+ *
+ * Values sharing a key are told apart by the predicate, owners are part of the key, the
+ * entries survive the growth of the table and clearing it drops them all, including when
+ * the generation wraps around.
+ */
+void index_table_checks() {
+    index_table table;
+    const std::uint64_t key = 42;
+    for(node_index v=0; v<100; ++v) { // same key, grows the table from 16 slots
+        table.insert(key,0,v);
+    }
+    table.insert(key,1,1000);
+    bool is_found = true;
+    for(node_index v=0; v<100; ++v) {
+        is_found = is_found && table.find(key,0,[&](node_index w) {return w == v;}) == v;
+    }
+    check(is_found && table.nb_entries == 101,"index_table: colliding values are all found after growth");
+    check(table.find(key,0,[](node_index w) {return w == 1000;}) == NULL_INDEX,"index_table: the owner is part of the key");
+    check(table.find(key,1,[](node_index) {return true;}) == 1000,"index_table: other owner found");
+    check(table.find(key + 1,0,[](node_index) {return true;}) == NULL_INDEX,"index_table: unknown key");
+
+    table.clear();
+    check(table.nb_entries == 0 && table.find(key,0,[](node_index) {return true;}) == NULL_INDEX,"index_table: clear drops every entry");
+    table.insert(key,0,7);
+    check(table.find(key,0,[](node_index) {return true;}) == 7,"index_table: insertion after clear");
+
+    table.generation = std::numeric_limits<unsigned>::max();
+    table.insert(key,0,8);
+    table.clear(); // wraps around
+    check(table.generation == 1 && table.find(key,0,[](node_index) {return true;}) == NULL_INDEX,"index_table: clear at generation wrap-around");
+}
+
+/**
+ * @brief Quantizer checks
+ *
+ * Cells are half-open intervals and the states close to a cell boundary probe the
+ * neighbouring cell.
+ */
+void quantizer_checks() {
+    state_quantizer q(1.);
+    check(q.cell(0.,0) == 0 && q.cell(.999,0) == 0 && q.cell(1.,0) == 1 && q.cell(-.001,0) == -1,"quantizer: cell boundaries");
+
+    state below(0,1. - 1e-12,.5,.5,.5);
+    state above(0,1.,.5,.5,.5);
+    std::vector<std::uint64_t> hashes;
+    q.for_each_candidate_hash(below,1e-10,[&](std::uint64_t h) {hashes.push_back(h); return false;});
+    check(hashes.size() == 2 && hashes[0] == q.hash(below) && hashes[1] == q.hash(above),"quantizer: neighbouring cell within tolerance");
+
+    state middle(0,.5,.5,.5,.5);
+    hashes.clear();
+    q.for_each_candidate_hash(middle,1e-10,[&](std::uint64_t h) {hashes.push_back(h); return false;});
+    check(hashes.size() == 1 && hashes[0] == q.hash(middle),"quantizer: single cell away from the boundaries");
+
+    state corner(0,1. - 1e-12,1. - 1e-12,.5,.5);
+    unsigned nb_candidates = 0;
+    q.for_each_candidate_hash(corner,1e-10,[&](std::uint64_t) {++nb_candidates; return false;});
+    check(nb_candidates == 4,"quantizer: every neighbouring cell of a corner");
+
+    check(q.hash(state(0,.5,.5,.5,.5)) != q.hash(state(1,.5,.5,.5,.5)),"quantizer: time is hashed exactly");
+}
+
+/**
+ * @brief Transposition checks
+ *
+ * With the transposition table, a state sampled from two chance nodes labels a single
+ * decision node, linked to both; without it, each chance node gets its own node.
+ */
+void transposition_checks() {
+    parameters p = search_parameters();
+    state s0;
+    p.parse_state(s0);
+    for(bool use_transposition_table : {true,false}) {
+        p.USE_TRANSPOSITION_TABLE = use_transposition_table;
+        planner pl(p);
+        pl.tree.clear();
+        node_index root = pl.add_dnode(s0,pl.model,0);
+        node_index c1 = pl.expand(root,pl.model);
+        node_index c2 = pl.expand(root,pl.model);
+        const std::shared_ptr<action> &a = pl.model.action_space[pl.tree.cnodes[c1].action];
+        state s_p;
+        pl.model.state_transition(s0,a,s_p);
+        double r = pl.model.reward_function(s0,a,s_p);
+        node_index v1 = pl.get_outcome(c1,s_p,r,pl.model);
+        node_index v2 = pl.get_outcome(c2,s_p,r,pl.model);
+        bool is_linked = pl.tree.cnodes[c1].nb_outcomes == 1 && pl.tree.cnodes[c2].nb_outcomes == 1;
+        if(use_transposition_table) {
+            check(is_linked && v1 == v2 && pl.tree.dnodes.size() == 2,"transposition: one decision node per state");
+            check(pl.get_outcome(c1,s_p,r,pl.model) == v1 && pl.tree.cnodes[c1].nb_outcomes == 1,"transposition: sampled state found again");
+        } else {
+            check(is_linked && v1 != v2 && pl.tree.dnodes.size() == 3,"transposition: one decision node per outcome without the table");
+        }
+    }
+}
+
+/**
+ * @brief Tree reuse checks
+ *
+ * The subtree of the observed outcome of the recommended action becomes the tree, with
+ * the statistics of its chance nodes; a state that was not sampled clears it.
+ */
+void tree_reuse_checks() {
+    parameters p = search_parameters();
+    p.REUSE_TREE = true;
+    state s0;
+    p.parse_state(s0);
+    planner pl(p);
+    std::shared_ptr<action> a = pl.search(s0);
+    state s1;
+    pl.model.state_transition(s0,a,s1);
+    node_index v = NULL_INDEX;
+    bool is_sampled = pl.is_state_already_sampled(pl.root_choice,s1,v);
+    check(is_sampled,"tree reuse: observed outcome sampled by the search");
+    if(!is_sampled) {
+        return;
+    }
+    std::vector<std::pair<unsigned,unsigned>> children; // action and number of visits
+    const dnode &d = pl.tree.dnodes[v];
+    for(node_index c = d.first_child; c < d.first_child + d.nb_children; ++c) {
+        children.emplace_back(pl.tree.cnodes[c].action,pl.tree.get_nb_visits(c));
+    }
+    unsigned nb_dnodes = pl.tree.dnodes.size();
+    node_index root = pl.promote_subtree(s1);
+    bool are_kept = root != NULL_INDEX && pl.tree.dnodes[root].nb_children == children.size();
+    for(unsigned i=0; are_kept && i<children.size(); ++i) {
+        node_index c = pl.tree.dnodes[root].first_child + i;
+        are_kept = pl.tree.cnodes[c].action == children[i].first && pl.tree.get_nb_visits(c) == children[i].second;
+    }
+    check(are_kept,"tree reuse: promoted root keeps the children of the outcome and their visits");
+    check(pl.tree.dnodes.size() < nb_dnodes && pl.root_choice == NULL_INDEX,"tree reuse: the other branches are dropped");
+
+    pl.search(s0);
+    check(pl.promote_subtree(s0) == NULL_INDEX,"tree reuse: state not sampled");
+}
+
+/**
+ * @brief Running statistics checks
+ *
+ * The merge of the statistics of two sets of samples (Chan et al.) matches the two-pass
+ * mean and variance of their union.
+ */
+void running_statistics_checks() {
+    std::vector<double> samples;
+    for(unsigned i=0; i<1000; ++i) {
+        samples.push_back(1e3 + std::sin((double) i) + ((i < 300) ? 5. : 0.));
+    }
+    running_statistics first, second;
+    for(unsigned i=0; i<samples.size(); ++i) {
+        (i < 300 ? first : second).add(samples[i]);
+    }
+    first.merge(second.count,second.mean,second.m2);
+    double mean = 0.;
+    for(double x : samples) {
+        mean += x;
+    }
+    mean /= (double) samples.size();
+    double variance = 0.;
+    for(double x : samples) {
+        variance += (x - mean) * (x - mean);
+    }
+    variance /= (double) samples.size();
+    check(first.get_count() == samples.size(),"running_statistics: merged count");
+    check(std::fabs(first.get_mean() - mean) < 1e-9,"running_statistics: merged mean");
+    check(std::fabs(first.get_variance() - variance) < 1e-9 * variance,"running_statistics: merged variance");
+
+    running_statistics empty;
+    empty.merge(0,3.,1.);
+    check(empty.get_count() == 0 && empty.get_mean() == 0. && empty.get_variance() == 0.,"running_statistics: empty merge");
+    empty.merge(second.count,second.mean,second.m2);
+    check(empty.get_mean() == second.get_mean() && empty.get_variance() == second.get_variance(),"running_statistics: merge into empty statistics");
+}
+
+/**
+ * @brief Deadline checks
+ *
+ * A search whose budget cannot be spent stops at the time limit, including in a shared
+ * tree, whose pools are then sized by the maximum number of records, which is required.
+ */
+void deadline_checks() {
+    parameters p = search_parameters();
+    p.TREE_SEARCH_BUDGET = 100000000;
+    p.DECISION_TIME_LIMIT = 20;
+    state s0;
+    p.parse_state(s0);
+    auto timed_plan = [&](const parameters &sp, double &nb_iterations) { // duration in ms
+        planner pl(sp);
+        auto start = std::chrono::steady_clock::now();
+        pl.plan(s0);
+        std::chrono::duration<double,std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        nb_iterations = pl.nb_iterations_spent;
+        return elapsed.count();
+    };
+    double nb_iterations = 0.;
+    double duration = timed_plan(p,nb_iterations);
+    check(duration >= 20. && duration < 200. && nb_iterations < p.TREE_SEARCH_BUDGET,"deadline: sequential search stopped at the time limit");
+
+    p.NB_THREADS = 2;
+    p.SHARED_TREE = true;
+    bool is_rejected = false;
+    try {
+        planner pl(p);
+    }
+    catch(const unbounded_shared_tree_exception &) {
+        is_rejected = true;
+    }
+    check(is_rejected,"deadline: shared tree without a maximum number of records rejected");
+    p.MAX_TREE_RECORDS = 100000;
+    duration = timed_plan(p,nb_iterations);
+    check(duration >= 20. && duration < 200. && nb_iterations < p.TREE_SEARCH_BUDGET,"deadline: shared tree search stopped at the time limit");
+}
+
+/**
+ * @brief Rollout cache checks
+ *
+ * The least recently used entry is evicted, a lookup refreshing the found entry.
+ */
+void rollout_cache_checks() {
+    rollout_cache cache(2);
+    state a(0,1.), b(0,2.), c(0,3.);
+    double value = 0.;
+    cache.insert(a,0,0,1.);
+    cache.insert(b,0,0,2.);
+    check(cache.find(a,0,0,value) && value == 1.,"rollout_cache: find");
+    cache.insert(c,0,0,3.); // evicts b, a being more recently used
+    check(!cache.find(b,0,0,value),"rollout_cache: least recently used entry evicted");
+    check(cache.find(a,0,0,value) && value == 1. && cache.find(c,0,0,value) && value == 3.,"rollout_cache: recent entries kept");
+    cache.insert(b,0,0,2.); // evicts a
+    check(!cache.find(a,0,0,value) && cache.find(b,0,0,value) && cache.find(c,0,0,value),"rollout_cache: eviction order follows the lookups");
+    cache.insert(c,0,0,4.);
+    check(cache.find(c,0,0,value) && value == 4. && cache.entries.size() == 2,"rollout_cache: same key replaced");
+    check(!cache.find(c,1,0,value) && !cache.find(c,0,1,value),"rollout_cache: action and signature are part of the key");
+
+    rollout_cache disabled(0);
+    disabled.insert(a,0,0,1.);
+    check(!disabled.find(a,0,0,value),"rollout_cache: null capacity");
+}
+
+/**
+ * @brief Count OLUCT records
+ *
+ * @param {const node &} v; node
+ * @return Return the number of nodes, sampled states and actions of the subtree of v.
+ */
+unsigned count_oluct_records(const node &v) {
+    unsigned n = 1 + (v.is_root() ? 0 : v.get_nb_sampled_states()) + v.get_action_space().size();
+    for(auto &c : v.children) {
+        n += count_oluct_records(c);
+    }
+    return n;
+}
+
+/**
+ * @brief OLUCT record cap checks
+ *
+ * The records of an OLUCT tree stay within the maximum, on a dynamic model, whose descents
+ * sample new states, and on a static one, the search ending once the tree is full.
+ */
+void oluct_record_cap_checks() {
+    parameters p = search_parameters();
+    p.TREE_SEARCH_BUDGET = 1000;
+    p.MAX_TREE_RECORDS = 2000;
+    state s0;
+    p.parse_state(s0);
+    for(bool is_model_dynamic : {true,false}) {
+        p.IS_MODEL_DYNAMIC = is_model_dynamic;
+        oluct<go_straight> pl(p);
+        pl.build_oluct_tree(s0);
+        std::string name = is_model_dynamic ? "dynamic" : "static";
+        check(pl.nb_records <= p.MAX_TREE_RECORDS && count_oluct_records(pl.root_node) <= p.MAX_TREE_RECORDS,"oluct: records within the maximum, " + name + " model");
+        check(pl.is_tree_full && pl.expd_counter < p.TREE_SEARCH_BUDGET,"oluct: search ended by the full tree, " + name + " model");
+    }
+}
+
+/**
+ * @brief State abstraction checks
+ *
+ * An abstracted coordinate compares cells, the other coordinates being compared up to the
+ * comparison threshold.
+ */
+void state_abstraction_checks() {
+    state_quantizer q(1.);
+    q.set_abstraction(0,1.);
+    check(q.is_equivalent(state(0,.1,.5,.5,.5),state(0,.9,.5,.5,.5)),"abstraction: abstracted coordinate, same cell");
+    check(!q.is_equivalent(state(0,.9,.5,.5,.5),state(0,1.1,.5,.5,.5)),"abstraction: abstracted coordinate, other cell");
+    check(!q.is_equivalent(state(0,.5,.1,.5,.5),state(0,.5,.2,.5,.5)),"abstraction: other coordinates up to the threshold");
+
+    parameters p = search_parameters();
+    p.STATE_ABSTRACTION_STEP_X = 1.;
+    state s0;
+    p.parse_state(s0);
+    planner pl(p);
+    pl.tree.clear();
+    node_index root = pl.add_dnode(s0,pl.model,0);
+    node_index c = pl.expand(root,pl.model);
+    state s1(s0.t + 1,std::floor(s0.x) + .1,s0.y,s0.v,s0.theta);
+    state s2(s0.t + 1,std::floor(s0.x) + .9,s0.y,s0.v,s0.theta);
+    node_index v1 = pl.get_outcome(c,s1,0.,pl.model);
+    check(pl.get_outcome(c,s2,0.,pl.model) == v1 && pl.tree.cnodes[c].nb_outcomes == 1,"abstraction: equivalent outcomes share a decision node");
+}
+
+/**
+ * @brief Double progressive widening checks
+ *
+ * On a noisy model, a chance node visited n times has at most ceil(k * n^alpha) outcomes
+ * (at least one), whereas it gets a new outcome at almost every visit without the
+ * widening.
+ */
+void dpw_checks() {
+    parameters p = search_parameters();
+    p.MODEL_STATE_GAUSSIAN_STDDEV = .01;
+    p.TREE_SEARCH_BUDGET = 1000;
+    state s0;
+    p.parse_state(s0);
+    for(double dpw_coefficient : {1.,0.}) {
+        p.DPW_COEFFICIENT = dpw_coefficient;
+        p.DPW_EXPONENT = .25;
+        planner pl(p);
+        pl.plan(s0);
+        bool is_capped = true;
+        unsigned max_nb_outcomes = 0;
+        for(node_index c=0; c<pl.tree.cnodes.size(); ++c) {
+            double n = pl.tree.get_nb_visits(c);
+            unsigned nb_outcomes = pl.tree.cnodes[c].nb_outcomes;
+            is_capped = is_capped && nb_outcomes <= std::max(1.,std::ceil(p.DPW_COEFFICIENT * pow(n,p.DPW_EXPONENT)));
+            max_nb_outcomes = std::max(max_nb_outcomes,nb_outcomes);
+        }
+        if(dpw_coefficient > 0.) {
+            check(is_capped,"dpw: outcomes of the chance nodes within ceil(k * n^alpha)");
+        } else {
+            check(max_nb_outcomes > 10,"dpw: outcomes of the chance nodes not capped without the widening");
+        }
+    }
+}
+
+/**
+ * @brief Rollout truncation checks
+ *
+ * A truncated rollout returns the untruncated return up to the truncation epsilon, from
+ * various starting states and headings, on a static and on a dynamic model.
+ */
+void rollout_truncation_checks() {
+    parameters p = search_parameters();
+    const double epsilon = 1e-4;
+    const unsigned horizon = 200;
+    environment model(p);
+    model.misstep_probability = 0.;
+    model.state_gaussian_stddev = 0.;
+    model.is_crash_terminal = true;
+    go_straight policy(p);
+    state s0;
+    p.parse_state(s0);
+    for(bool is_model_dynamic : {false,true}) {
+        rollout_engine full(p.DISCOUNT_FACTOR,horizon,is_model_dynamic,0.);
+        rollout_engine truncated(p.DISCOUNT_FACTOR,horizon,is_model_dynamic,epsilon);
+        bool is_within_epsilon = true;
+        unsigned nb_full_steps = 0;
+        unsigned nb_truncated_steps = 0;
+        for(unsigned i=0; i<8; ++i) {
+            for(unsigned j=0; j<8; ++j) {
+                state s = s0;
+                s.x += .1 * i;
+                s.y += .1 * j;
+                s.theta = M_PI * (i + j) / 4.;
+                environment full_model(model);
+                environment truncated_model(model);
+                double q = full.run(s,policy(s),full_model,policy,nb_full_steps);
+                double q_truncated = truncated.run(s,policy(s),truncated_model,policy,nb_truncated_steps);
+                is_within_epsilon = is_within_epsilon && std::fabs(q - q_truncated) <= epsilon;
+            }
+        }
+        std::string name = is_model_dynamic ? "dynamic" : "static";
+        check(is_within_epsilon,"truncation: returns within epsilon, " + name + " model");
+        check(nb_truncated_steps < nb_full_steps,"truncation: fewer simulated steps, " + name + " model");
+    }
+}
+
+/**
+ * @brief Iterative descent checks
+ *
+ * The sample added to each chance node of the path by an iteration is the one the
+ * recursive backup computes, q = r + discount_factor * q from the return of the new
+ * chance node, and the rewards recorded along the path are those of the transitions
+ * replayed from the root.
+ */
+void iterative_descent_checks() {
+    parameters p = search_parameters();
+    state s0;
+    p.parse_state(s0);
+    planner pl(p);
+    pl.tree.clear();
+    node_index root = pl.add_dnode(s0,pl.model,0);
+    search_workspace &ws = pl.workspaces[0];
+    bool are_returns_equal = true;
+    bool are_rewards_equal = true;
+    std::vector<unsigned> visits;
+    std::vector<double> totals;
+    for(unsigned i=0; i<p.TREE_SEARCH_BUDGET; ++i) {
+        visits.resize(pl.tree.cnodes.size());
+        totals.resize(pl.tree.cnodes.size());
+        for(node_index c=0; c<totals.size(); ++c) {
+            visits[c] = pl.tree.get_nb_visits(c);
+            totals[c] = pl.tree.get_nb_visits(c) * pl.tree.get_value(c);
+        }
+        double q = pl.search_tree(root,pl.model,ws);
+        auto sample = [&](node_index c) { // return added to the statistics of c
+            double total = (c < totals.size()) ? totals[c] : 0.;
+            return pl.tree.get_nb_visits(c) * pl.tree.get_value(c) - total;
+        };
+        double expected = pl.terminal_state_value;
+        for(node_index c=0; c<pl.tree.cnodes.size(); ++c) { // new chance node, if any
+            bool is_new = pl.tree.get_nb_visits(c) == 1 && (c >= visits.size() || visits[c] == 0);
+            if(is_new && std::none_of(ws.path.begin(),ws.path.end(),[c](const search_workspace::step &st) {return st.c == c;})) {
+                expected = sample(c);
+            }
+        }
+        for(auto it = ws.path.rbegin(); it != ws.path.rend(); ++it) { // recursive backup
+            expected = it->reward + pl.discount_factor * expected;
+            are_returns_equal = are_returns_equal && std::fabs(sample(it->c) - expected) < 1e-9;
+        }
+        are_returns_equal = are_returns_equal && std::fabs(q - expected) < 1e-9;
+
+        state s = s0;
+        for(auto &st : ws.path) { // replay
+            const std::shared_ptr<action> &a = pl.model.action_space[pl.tree.cnodes[st.c].action];
+            state s_p;
+            pl.model.state_transition(s,a,s_p);
+            are_rewards_equal = are_rewards_equal && pl.model.reward_function(s,a,s_p) == st.reward;
+            s = s_p;
+        }
+    }
+    check(are_returns_equal,"descent: path returns match the recursive backup");
+    check(are_rewards_equal,"descent: path rewards match the replayed transitions");
+}
+
+/**
+ * @brief Sequential halving checks
+ *
+ * Rounds and halving of 0, 1 and 2 arms, and of an odd number of arms; a search cut by
+ * the time limit still runs every round, each one getting a share of the time, so that a
+ * single arm remains.
+ */
+void halving_checks() {
+    check(nb_halving_rounds(0) == 0 && nb_halving_rounds(1) == 0,"halving: no round for at most one arm");
+    check(nb_halving_rounds(2) == 1 && nb_halving_rounds(3) == 2 && nb_halving_rounds(4) == 2 && nb_halving_rounds(5) == 3,"halving: ceil(log2) rounds");
+
+    auto value = [](unsigned i) {return (double) i;};
+    std::vector<unsigned> arms;
+    halve_arms(arms,value);
+    check(arms.empty(),"halving: no arm");
+    arms = {3};
+    halve_arms(arms,value);
+    check(arms == std::vector<unsigned>{3},"halving: single arm kept");
+    arms = {1,2};
+    halve_arms(arms,value);
+    check(arms == std::vector<unsigned>{2},"halving: best of two arms kept");
+    arms = {4,0,2};
+    halve_arms(arms,value);
+    check(arms == std::vector<unsigned>{4,2},"halving: best half rounded up");
+
+    parameters p = search_parameters();
+    p.MCTS_STRATEGY_SWITCH = 2;
+    p.TREE_SEARCH_BUDGET = 100000000;
+    p.DECISION_TIME_LIMIT = 20;
+    state s0;
+    p.parse_state(s0);
+    planner pl(p);
+    pl.plan(s0);
+    check(pl.halving_arms.size() == 1 && pl.nb_iterations_spent < p.TREE_SEARCH_BUDGET,"halving: every round run within the time limit, mcts");
+    oluct<go_straight> ol(p);
+    ol.build_oluct_tree(s0);
+    check(ol.halving_arms.size() == 1 && ol.expd_counter < p.TREE_SEARCH_BUDGET,"halving: every round run within the time limit, oluct");
+}
+
+/**
+ * @brief Main function
+ */
+int main() {
+    try {
+        srand(time(NULL));
+        index_table_checks();
+        quantizer_checks();
+        transposition_checks();
+        tree_reuse_checks();
+        running_statistics_checks();
+        deadline_checks();
+        rollout_cache_checks();
+        oluct_record_cap_checks();
+        state_abstraction_checks();
+        dpw_checks();
+        rollout_truncation_checks();
+        iterative_descent_checks();
+        halving_checks();
+    }
+    catch(const std::exception &e) {
+        std::cerr << "Error in main(): standard exception caught: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << nb_failures << " failed check(s)" << std::endl;
+    return (nb_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -33,13 +33,14 @@ void backup(
     std::vector<std::vector<double>> &backup_vector)
 {
     en.trajectory_backup(ag.s);
-    en.rmodel->reward_backup();
+    en.rmodel.reward_backup();
     en.save_trajectory();
-    en.rmodel->save_reward_backup();
+    en.rmodel.save_reward_backup();
     std::vector<double> simbackup = {
         (double) ag.s.t, /* time */
         achieved_return, /* total collected reward */
-        time_elapsed_ms /* computational cost */
+        time_elapsed_ms, /* computational cost */
+        ag.get_speculation_hit_rate() /* ratio of the searches at a predicted state that were used */
     };
     std::vector<double> agbackup = ag.policy.get_backup(); // agent backup
     simbackup.insert(simbackup.end(),agbackup.begin(),agbackup.end());
@@ -65,10 +66,18 @@ void single_run(
 {
     environment en(p);
     agent<PLC> ag(p);
+    environment predictor(en); // noise-free transitions, used in pipelined mode
+    predictor.misstep_probability = 0.;
+    predictor.state_gaussian_stddev = 0.;
     double achieved_return = 0.; // total collected reward
 	std::clock_t c_start = std::clock();
     for(unsigned t = 0; t < p.SIMULATION_LIMIT_TIME; ++t) { // main loop
         ag.apply_policy();
+        if(p.IS_PLANNING_PIPELINED && t + 1 < p.SIMULATION_LIMIT_TIME) { // plan the next step while this one is applied
+            state predicted_s;
+            predictor.state_transition(ag.s,ag.a,predicted_s);
+            ag.speculate(predicted_s);
+        }
         en.transition(ag.s,ag.a,ag.reward,ag.s_p);
         ag.process_reward();
         if(prnt) {
@@ -77,7 +86,7 @@ void single_run(
         if(bckp) {
             achieved_return += ag.reward;
             en.trajectory_backup(ag.s);
-            en.rmodel->reward_backup();
+            en.rmodel.reward_backup();
         }
         ag.step();
         en.step(ag.s);
@@ -85,6 +94,7 @@ void single_run(
             break;
         }
     }
+    ag.cancel_speculation();
     std::clock_t c_end = std::clock();
     double time_elapsed_ms = 1000. * (c_end - c_start) / CLOCKS_PER_SEC;
     if(prnt) {
@@ -186,7 +196,11 @@ void run(
         "score",
         "achieved_return",
         "computational_cost",
-        "nb_calls"
+        "speculation_hit_rate",
+        "nb_calls",
+        "reused_budget",
+        "rollout_hit_rate",
+        "iterations_per_decision"
     };
     std::string sep = ","; // separator for backup file
     if(bckp) { // initialize backup names
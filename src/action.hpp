@@ -4,6 +4,29 @@
 #include <state.hpp>
 #include <utils.hpp>
 
+/**
+ * @brief Action kinematics
+ *
+ * Branch-free form of an action, used to apply it to several states in lockstep.
+ * With (c,s) the direction (cos(theta),sin(theta)) of the state, the action gives:
+ * v' = keep * clamp(fv * v, vmin, vmax) + (1 - keep) * vmax, theta' = keep * theta + dtheta,
+ * (c',s') = keep * rotation of (c,s) by dtheta + (1 - keep) * (cos(dtheta),sin(dtheta)),
+ * (x',y') = (x,y) + keep * v' * (c',s') + (1 - keep) * (dx,dy),
+ * where keep is 1 for an action relative to the current heading, else 0.
+ */
+class action_kinematics {
+public:
+    double fv; ///< Velocity factor
+    double vmin; ///< Minimum velocity
+    double vmax; ///< Maximum velocity, or velocity if the heading is not kept
+    double keep; ///< 1 if the heading and velocity of the state are kept, else 0
+    double dtheta; ///< Angle variation, or angle if the heading is not kept
+    double cos_dtheta; ///< Cosine of dtheta
+    double sin_dtheta; ///< Sine of dtheta
+    double dx; ///< Variation along x coordinate if the heading is not kept
+    double dy; ///< Variation along y coordinate if the heading is not kept
+};
+
 /**
  * @brief Action class
  */
@@ -19,6 +42,33 @@ public:
      */
     virtual void apply(state &s) = 0;
 
+    /**
+     * @brief Get speed bound
+     *
+     * Get a value c such that, starting from a state of velocity v, the distance travelled
+     * at each application of the action, and the velocity of the resulting states, is at
+     * most max(v,c) however many times the action is applied.
+     * Used to bound the region reachable by a rollout; the default implementation assumes
+     * that there is no such bound.
+     * @return Return the speed bound.
+     */
+    virtual double get_speed_bound() const {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    /**
+     * @brief Get kinematics
+     *
+     * Get the branch-free form of the action, see 'action_kinematics'; the default
+     * implementation assumes that there is none.
+     * @param {action_kinematics &} k; kinematics, set if any
+     * @return Return true if the action has a branch-free form.
+     */
+    virtual bool get_kinematics(action_kinematics &k) const {
+        (void) k;
+        return false;
+    }
+
     /**
      * @brief Set to default
      *
@@ -2,11 +2,16 @@
 #define AGENT_HPP_
 
 #include <environment.hpp>
+#include <thread_pool.hpp>
 
 /**
  * @brief Agent class
  *
  * Agent template class.
+ * In pipelined mode, the policy searches on a background thread from the predicted next
+ * state while the undertaken action is applied (see 'speculate'); the policy must then
+ * provide 'search', 'update_model', 'discard_search', 'stop_search' and 'clear_stop', and
+ * its 'process_reward' method may run during the search.
  */
 template <class PLC>
 class agent {
@@ -17,6 +22,12 @@ public:
     state s_p; ///< Next state of the agent
     std::shared_ptr<action> a; ///< Action selected by the policy
     double reward; ///< Reward from transition (s,a,s_p)
+    std::unique_ptr<thread_pool> speculation_pool; ///< Thread running the searches at the predicted states, null unless pipelined
+    bool is_speculating; ///< Set while a search at the predicted state is running or its action not used
+    std::shared_ptr<action> speculated_a; ///< Action recommended by the search at the predicted state
+    state predicted_s; ///< Predicted next state, root of the running search
+    unsigned nb_speculations; ///< Number of searches run at a predicted state
+    unsigned nb_promoted_speculations; ///< Number of searches whose predicted state was reached
 
     /**
      * @brief Default constructor
@@ -24,20 +35,89 @@ public:
      * Default constructor initialising the parameters via a 'parameters' object.
      * @param {const parameters &} p; parameters
      */
-    agent(const parameters &p) : policy(p) {
+    agent(const parameters &p) : policy(p), is_speculating(false), nb_speculations(0), nb_promoted_speculations(0) {
         p.parse_state(s);
         s_p = s;
+        if(p.IS_PLANNING_PIPELINED) {
+            speculation_pool.reset(new thread_pool(1));
+        }
+    }
+
+    /**
+     * @brief Destructor
+     *
+     * Wait for the end of the running search, if any.
+     */
+    ~agent() {
+        cancel_speculation();
     }
 
     /**
      * @brief Apply policy
      *
      * Modify the action attribute wrt the state attribute and the chosen policy.
+     * If a search is running at the predicted state and the prediction is right, its
+     * action is undertaken; otherwise it is stopped and discarded before searching at the
+     * actual state.
      */
     void apply_policy() {
+        if(is_speculating) {
+            if(predicted_s.is_equal_to(s)) { // the search is promoted
+                speculation_pool->wait();
+                is_speculating = false;
+                a = speculated_a;
+                policy.update_model(s);
+                ++nb_promoted_speculations;
+                return;
+            }
+            cancel_speculation();
+        }
         a = policy(s);
     }
 
+    /**
+     * @brief Speculate
+     *
+     * Start searching at the predicted next state on the speculation thread, the search
+     * being used by the next call to 'apply_policy' if the prediction is right.
+     * Only in pipelined mode.
+     * @param {const state &} _predicted_s; predicted next state
+     */
+    void speculate(const state &_predicted_s) {
+        cancel_speculation();
+        predicted_s = _predicted_s;
+        ++nb_speculations;
+        is_speculating = true;
+        speculation_pool->submit([this]() {
+            speculated_a = policy.search(predicted_s);
+        });
+    }
+
+    /**
+     * @brief Cancel speculation
+     *
+     * Stop and discard the running search, if any; the stop request is then cleared for
+     * the next search.
+     */
+    void cancel_speculation() {
+        if(is_speculating) {
+            policy.stop_search();
+            speculation_pool->wait();
+            policy.discard_search();
+            policy.clear_stop();
+            is_speculating = false;
+        }
+    }
+
+    /**
+     * @brief Get speculation hit rate
+     *
+     * @return Return the ratio of the searches run at a predicted state that were used.
+     */
+    double get_speculation_hit_rate() const {
+        return (nb_speculations == 0) ? 0. : ((double) nb_promoted_speculations) / ((double) nb_speculations);
+    }
+
     /**
      * @brief Process reward
      *
@@ -62,6 +62,27 @@ public:
         s.theta = _theta;
     }
 
+    /**
+     * @brief Get speed bound
+     *
+     * The displacement is constant.
+     * @return Return the speed bound.
+     */
+    double get_speed_bound() const override {
+        return _v;
+    }
+
+    /**
+     * @brief Get kinematics
+     *
+     * @param {action_kinematics &} k; kinematics
+     * @return Return true.
+     */
+    bool get_kinematics(action_kinematics &k) const override {
+        k = {1.,_v,_v,0.,_theta,cos(_theta),sin(_theta),dx,dy};
+        return true;
+    }
+
     /**
      * @brief Set to default
      *
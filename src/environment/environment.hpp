@@ -16,7 +16,7 @@ public:
     double xsize; ///< Horizontal dimension of the environment
     double ysize; ///< Vertical dimension of the environment
     boost::ptr_vector<shape> walls; ///< Walls of the environment
-    std::unique_ptr<reward_model> rmodel; ///< Reward model of the environment
+    reward_model_variant rmodel; ///< Reward model of the environment, held by value
     double misstep_probability; ///< Probability of misstep
     double state_gaussian_stddev; ///< Standard deviation of the Gaussian noise applied on the position
     double wall_reward;
@@ -53,7 +53,7 @@ public:
         xsize = en.xsize;
         ysize = en.ysize;
         walls = en.walls;
-        rmodel = std::unique_ptr<reward_model>(en.rmodel->duplicate());
+        rmodel = en.rmodel;
         misstep_probability = en.misstep_probability;
         state_gaussian_stddev = en.state_gaussian_stddev;
         wall_reward = en.wall_reward;
@@ -175,36 +175,45 @@ public:
      * @param {const state &} s; state
      * @param {const std::shared_ptr<action> &} a; copy of the action
      * @param {state &} s_p; next state
+     * @return Return true if the next state is valid i.e. not within a wall.
      */
-    void state_transition(
+    bool state_transition(
         const state &s,
         const std::shared_ptr<action> &a,
         state &s_p)
     {
         s_p = s;
-        if(is_less_than(uniform_double(0.,1.),misstep_probability)) { // misstep
+        bool is_valid;
+        if(misstep_probability > 0. && is_less_than(uniform_double(0.,1.),misstep_probability)) { // misstep
             rand_element(get_action_space(s))->apply(s_p);
-            if(!is_state_valid(s_p)) { // misstep led to a wall, state is unchanged
+            is_valid = is_state_valid(s_p);
+            if(!is_valid) { // misstep led to a wall, state is unchanged
                 s_p = s;
+                is_valid = is_state_valid(s_p);
             }
         } else { // no misstep
             a->apply(s_p);
-            if(!is_state_valid(s_p) && !is_crash_terminal) { // action led to a wall, angle is reverted
+            is_valid = is_state_valid(s_p);
+            if(!is_valid && !is_crash_terminal) { // action led to a wall, angle is reverted
                 s_p.theta += M_PI;
             }
         }
-        for(unsigned i=0; i<50; ++i) { // 50 trials for gaussian application - no gaussian if no valid result
-            state _s_p = s_p;
-            _s_p.x += normal_double(0.,state_gaussian_stddev);
-            _s_p.y += normal_double(0.,state_gaussian_stddev);
-            _s_p.v += normal_double(0.,state_gaussian_stddev);
-            _s_p.theta += normal_double(0.,state_gaussian_stddev);
-            if(is_state_valid(_s_p)) {
-                s_p = _s_p;
-                break;
+        if(state_gaussian_stddev > 0.) { // the validity only depends on the position
+            for(unsigned i=0; i<50; ++i) { // 50 trials for gaussian application - no gaussian if no valid result
+                state _s_p = s_p;
+                _s_p.x += normal_double(0.,state_gaussian_stddev);
+                _s_p.y += normal_double(0.,state_gaussian_stddev);
+                _s_p.v += normal_double(0.,state_gaussian_stddev);
+                _s_p.theta += normal_double(0.,state_gaussian_stddev);
+                if(is_state_valid(_s_p)) {
+                    s_p = _s_p;
+                    is_valid = true;
+                    break;
+                }
             }
         }
         mod_angle(s_p);
+        return is_valid;
     }
 
     /**
@@ -219,15 +228,54 @@ public:
     double reward_function(
         const state &s,
         const std::shared_ptr<action> &a,
-        const state &s_p)
+        const state &s_p) const
     {
         if(is_wall_encountered_at(s)) { //TODO maybe unify world and reward_model classes if no polymorphism
             return wall_reward;
         } else {
-            return rmodel->get_reward_value_at(s,a,s_p);
+            return rmodel.get_reward_value_at(s,a,s_p);
         }
     }
 
+    /**
+     * @brief Nominal reward
+     *
+     * Reward of the noise-free transition from the given state with the given action, i.e.
+     * without misstep nor Gaussian noise; used as a cheap heuristic value of the action.
+     * @param {const state &} s; state
+     * @param {const std::shared_ptr<action> &} a; action
+     * @return Return the reward.
+     */
+    double nominal_reward(const state &s, const std::shared_ptr<action> &a) const {
+        state s_p = s;
+        a->apply(s_p);
+        return reward_function(s,a,s_p);
+    }
+
+    /**
+     * @brief Rollout transition
+     *
+     * Fused transition operator of the rollouts: the reward is computed from the wall test
+     * of the current state, carried over from the previous transition, and the wall test of
+     * the next state done by the state transition is returned for the next one.
+     * @param {const state &} s; state
+     * @param {bool &} is_in_wall; set to true if s is within a wall, updated for s_p
+     * @param {const std::shared_ptr<action> &} a; action
+     * @param {double &} r; reward
+     * @param {state &} s_p; next state
+     */
+    void rollout_transition(
+        const state &s,
+        bool &is_in_wall,
+        const std::shared_ptr<action> &a,
+        double &r,
+        state &s_p)
+    {
+        bool is_s_p_in_wall = !state_transition(s,a,s_p);
+        r = is_in_wall ? wall_reward : rmodel.get_reward_value_at(s,a,s_p);
+        is_in_wall = is_s_p_in_wall;
+    }
+
     /**
      * @brief Transition operator
      *
@@ -257,13 +305,64 @@ public:
      * @return Return true if the test is terminal, else false.
      */
     bool is_terminal(const state &s) const {
+        return is_terminal(s,is_crash_terminal && is_wall_encountered_at(s));
+    }
+
+    /**
+     * @brief Is terminal
+     *
+     * Same as above given the wall test of the state, e.g. from 'rollout_transition'.
+     * @param {const state &} s; given state
+     * @param {bool} is_in_wall; set to true if s is within a wall
+     * @return Return true if the test is terminal, else false.
+     */
+    bool is_terminal(const state &s, bool is_in_wall) const {
         return (
-            (is_wall_encountered_at(s) && is_crash_terminal) /* Crash */
-            || rmodel->is_terminal(s) /* Reward model says terminal eg waypoints reached*/
+            (is_in_wall && is_crash_terminal) /* Crash */
+            || rmodel.is_terminal(s) /* Reward model says terminal eg waypoints reached*/
             || s.is_terminal() /* State is terminal */
         );
     }
 
+    /**
+     * @brief Get signature
+     *
+     * Hash of the part of the internal state of the environment that is not a function
+     * of the time, see 'reward_model::get_signature'.
+     * @return Return the signature.
+     */
+    std::uint64_t get_signature() const {
+        return rmodel.get_signature();
+    }
+
+    /**
+     * @brief Get speed bound
+     *
+     * Speed bound of the action space, see 'action::get_speed_bound', which also holds for
+     * any sequence of actions of the space.
+     * @return Return the speed bound.
+     */
+    double get_speed_bound() const {
+        double bound = 0.;
+        for(auto &a : action_space) {
+            bound = std::max(bound,a->get_speed_bound());
+        }
+        return bound;
+    }
+
+    /**
+     * @brief Get maximum reward within
+     *
+     * Upper bound of the absolute reward value within the given distance of the given
+     * state, the reward within the walls included.
+     * @param {const state &} s; given state
+     * @param {double} reach; distance to the given state
+     * @return Return the bound.
+     */
+    double get_max_reward_within(const state &s, double reach) const {
+        return std::max(fabs(wall_reward),rmodel.get_max_reward_within(s,reach));
+    }
+
     /**
      * @brief Step
      *
@@ -271,7 +370,7 @@ public:
      * @param {const state &} s; state of the agent
      */
     void step(const state &s) {
-        rmodel->update(s);
+        rmodel.update(s);
     }
 
     /**
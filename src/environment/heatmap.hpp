@@ -7,18 +7,19 @@
 /**
  * @brief Heatmap reward model
  */
-class heatmap : public reward_model {
+class heatmap final : public reward_model {
 public:
-    std::vector<gaussian_reward_field> rfield; ///< Reward field container
-    std::vector<std::vector<std::vector<double>>> trajectories; ///< Trajectories
+    std::shared_ptr<std::vector<gaussian_reward_field>> rfield; ///< Reward field container, shared by the copies of the model until one of them is updated
+    std::vector<std::vector<std::vector<double>>> trajectories; ///< Trajectories, empty until the first reward backup
     std::vector<std::string> trajectories_output_paths;
 
     /**
      * @brief Constructor
      */
-    heatmap(std::vector<gaussian_reward_field> _rfield) : rfield(_rfield) {
-        trajectories.resize(rfield.size());
-        trajectories_output_paths.reserve(rfield.size());
+    heatmap(std::vector<gaussian_reward_field> _rfield) :
+        rfield(std::make_shared<std::vector<gaussian_reward_field>>(std::move(_rfield)))
+    {
+        trajectories_output_paths.reserve(rfield->size());
     }
 
     reward_model * duplicate() const override DUPLICATE_DEFAULT_BODY
@@ -40,7 +41,7 @@ public:
         (void) a;
         (void) s_p;
         double value = 0.;
-        for(auto &elt : rfield) {
+        for(auto &elt : *rfield) {
             value += elt.get_value(s);
         }
         return value;
@@ -49,12 +50,12 @@ public:
     /**
      * @brief Update reward model
      *
-     * Update the reward model wrt current state of the agent.
+     * Update the reward model wrt current state of the agent, the reward fields being
+     * copied first if they are shared with another model.
      * @param {const state &} s; current state of the agent
      */
     void update(const state &s) {
-        (void) s;
-        for(auto &elt : rfield) {
+        for(auto &elt : get_unshared(rfield)) {
             elt.step(s);
         }
     }
@@ -70,14 +71,45 @@ public:
         return false; // no termination criterion with this reward model
     }
 
+    /**
+     * @brief Get signature
+     *
+     * The reward fields move with the time only, hence there is nothing to hash.
+     * @return Return the signature.
+     */
+    std::uint64_t get_signature() const override {
+        return 0;
+    }
+
+    /**
+     * @brief Get maximum reward within
+     *
+     * The Gaussian fields have an unbounded support, hence the bound is the sum of the
+     * magnitudes of the fields that are not dead yet.
+     * @param {const state &} s; given state
+     * @param {double} reach; distance to the given state
+     * @return Return the bound.
+     */
+    double get_max_reward_within(const state &s, double reach) const override {
+        (void) reach;
+        double bound = 0.;
+        for(auto &elt : *rfield) {
+            if(s.t <= elt.tdeath) {
+                bound += fabs(elt.magnitude);
+            }
+        }
+        return bound;
+    }
+
     /**
      * @brief Reward backup
      *
      * If necessary, for reward backup.
      */
     void reward_backup() override {
-        for(unsigned i = 0; i < rfield.size(); ++i) {
-            trajectories[i].emplace_back(std::vector<double>{rfield[i].x,rfield[i].y});
+        trajectories.resize(rfield->size());
+        for(unsigned i = 0; i < rfield->size(); ++i) {
+            trajectories[i].emplace_back(std::vector<double>{(*rfield)[i].x,(*rfield)[i].y});
         }
     }
 
@@ -87,7 +119,7 @@ public:
      * If necessary, for reward backup.
      */
     void save_reward_backup() const override {
-        for(unsigned i = 0; i < rfield.size(); ++i) {
+        for(unsigned i = 0; i < trajectories.size(); ++i) {
             std::string path = "data/rfield" + std::to_string(i) + ".csv";
             initialize_backup(std::vector<std::string>{"x","y"},path,",");
             save_matrix(trajectories[i],path,",",std::ofstream::app);
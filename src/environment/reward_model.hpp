@@ -1,6 +1,8 @@
 #ifndef REWARD_MODEL_HPP_
 #define REWARD_MODEL_HPP_
 
+#include <cstdint>
+#include <limits>
 #include <type_traits>
 
 #define DUPLICATE_DEFAULT_BODY {return new typename std::decay<decltype(*this)>::type(*this);}
@@ -48,6 +50,37 @@ public:
      */
     virtual bool is_terminal(const state &s) const = 0;
 
+    /**
+     * @brief Get signature
+     *
+     * Get a hash of the part of the internal state of the model that is not a function
+     * of the time, e.g. the remaining waypoints.
+     * Used to tell apart identical states reached with differently updated models.
+     * The default implementation assumes that there is no such part.
+     * @return Return the signature.
+     */
+    virtual std::uint64_t get_signature() const {
+        return 0;
+    }
+
+    /**
+     * @brief Get maximum reward within
+     *
+     * Get an upper bound of the absolute reward value at the states lying within the given
+     * distance of the given state, at its time or later, the model being possibly updated
+     * meanwhile.
+     * Used to truncate the rollouts that may not collect any significant reward anymore.
+     * The default implementation assumes that there is no such bound.
+     * @param {const state &} s; given state
+     * @param {double} reach; distance to the given state
+     * @return Return the bound.
+     */
+    virtual double get_max_reward_within(const state &s, double reach) const {
+        (void) s;
+        (void) reach;
+        return std::numeric_limits<double>::infinity();
+    }
+
     /**
      * @brief Reward backup
      *
@@ -0,0 +1,211 @@
+#ifndef REWARD_MODEL_VARIANT_HPP_
+#define REWARD_MODEL_VARIANT_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <variant>
+
+#include <reward_model.hpp>
+#include <heatmap.hpp>
+#include <waypoints.hpp>
+
+/**
+ * @brief User-defined reward model
+ *
+ * Owning wrapper around a reward model implementing the virtual interface.
+ * Copies are deep copies obtained with the 'duplicate' method of the model.
+ */
+class user_reward_model {
+public:
+    std::unique_ptr<reward_model> ptr; ///< Pointer to the wrapped reward model
+
+    /**
+     * @brief Constructor
+     *
+     * @param {std::unique_ptr<reward_model>} _ptr; wrapped reward model, ownership is taken
+     */
+    user_reward_model(std::unique_ptr<reward_model> _ptr) : ptr(std::move(_ptr)) {}
+
+    /**
+     * @brief Copy constructor
+     */
+    user_reward_model(const user_reward_model &m) : ptr(m.ptr->duplicate()) {}
+
+    /** @brief Move constructor */
+    user_reward_model(user_reward_model &&m) = default;
+
+    /**
+     * @brief Copy assignment
+     */
+    user_reward_model & operator=(const user_reward_model &m) {
+        ptr.reset(m.ptr->duplicate());
+        return *this;
+    }
+
+    /** @brief Move assignment */
+    user_reward_model & operator=(user_reward_model &&m) = default;
+
+    /** @brief Reward value of the wrapped model */
+    double get_reward_value_at(
+        const state &s,
+        const std::shared_ptr<action> &a,
+        const state &s_p) const
+    {
+        return ptr->get_reward_value_at(s,a,s_p);
+    }
+
+    /** @brief Update the wrapped model */
+    void update(const state &s) {
+        ptr->update(s);
+    }
+
+    /** @brief Termination criterion of the wrapped model */
+    bool is_terminal(const state &s) const {
+        return ptr->is_terminal(s);
+    }
+
+    /** @brief Signature of the wrapped model */
+    std::uint64_t get_signature() const {
+        return ptr->get_signature();
+    }
+
+    /** @brief Maximum reward of the wrapped model within the given distance */
+    double get_max_reward_within(const state &s, double reach) const {
+        return ptr->get_max_reward_within(s,reach);
+    }
+
+    /** @brief Reward backup of the wrapped model */
+    void reward_backup() {
+        ptr->reward_backup();
+    }
+
+    /** @brief Save reward backup of the wrapped model */
+    void save_reward_backup() const {
+        ptr->save_reward_backup();
+    }
+};
+
+/**
+ * @brief Reward model variant
+ *
+ * Reward model holder storing one of the built-in reward models by value.
+ * The set of built-in models being closed, calls are dispatched statically on the held
+ * alternative and may be inlined, while copies do not require any heap allocation for
+ * the model itself.
+ * Reward models defined by the user through the virtual 'reward_model' interface are
+ * stored in the 'user_reward_model' alternative.
+ */
+class reward_model_variant {
+public:
+    std::variant<heatmap, waypoints, user_reward_model> model; ///< Held reward model
+
+    /**
+     * @brief Default constructor
+     *
+     * Hold an empty waypoints reward model.
+     */
+    reward_model_variant() : model(waypoints(std::vector<circle>{},0.)) {}
+
+    /**
+     * @brief Constructor
+     *
+     * @param {const heatmap &} m; heatmap reward model
+     */
+    reward_model_variant(const heatmap &m) : model(m) {}
+
+    /**
+     * @brief Constructor
+     *
+     * @param {const waypoints &} m; waypoints reward model
+     */
+    reward_model_variant(const waypoints &m) : model(m) {}
+
+    /**
+     * @brief Constructor
+     *
+     * @param {std::unique_ptr<reward_model>} ptr; user-defined reward model, ownership is taken
+     */
+    reward_model_variant(std::unique_ptr<reward_model> ptr) :
+        model(user_reward_model(std::move(ptr)))
+    {}
+
+    /**
+     * @brief Reward value
+     *
+     * Evaluate the reward value at the given state.
+     * @param {state &} s; state
+     * @param {const std::shared_ptr<action> &} a; action
+     * @param {state &} s_p; next state
+     * @return Return the value of the reward.
+     */
+    double get_reward_value_at(
+        const state &s,
+        const std::shared_ptr<action> &a,
+        const state &s_p) const
+    {
+        return std::visit([&](const auto &m) {return m.get_reward_value_at(s,a,s_p);}, model);
+    }
+
+    /**
+     * @brief Update reward model
+     *
+     * Update the reward model wrt current state of the agent e.g. remove a waypoint.
+     * @param {const state &} s; current state of the agent
+     */
+    void update(const state &s) {
+        std::visit([&](auto &m) {m.update(s);}, model);
+    }
+
+    /**
+     * @brief Is terminal
+     *
+     * Test whether it is terminal wrt state or reward model.
+     * @param {const state &} s; real state of the agent
+     */
+    bool is_terminal(const state &s) const {
+        return std::visit([&](const auto &m) {return m.is_terminal(s);}, model);
+    }
+
+    /**
+     * @brief Get signature
+     *
+     * Hash of the part of the internal state of the model that is not a function of time.
+     * @return Return the signature.
+     */
+    std::uint64_t get_signature() const {
+        return std::visit([](const auto &m) {return m.get_signature();}, model);
+    }
+
+    /**
+     * @brief Get maximum reward within
+     *
+     * Upper bound of the absolute reward value within the given distance of the given
+     * state, see 'reward_model::get_max_reward_within'.
+     * @param {const state &} s; given state
+     * @param {double} reach; distance to the given state
+     * @return Return the bound.
+     */
+    double get_max_reward_within(const state &s, double reach) const {
+        return std::visit([&](const auto &m) {return m.get_max_reward_within(s,reach);}, model);
+    }
+
+    /**
+     * @brief Reward backup
+     *
+     * If necessary, for reward backup.
+     */
+    void reward_backup() {
+        std::visit([](auto &m) {m.reward_backup();}, model);
+    }
+
+    /**
+     * @brief Save reward backup
+     *
+     * If necessary, for reward backup.
+     */
+    void save_reward_backup() const {
+        std::visit([](const auto &m) {m.save_reward_backup();}, model);
+    }
+};
+
+#endif // REWARD_MODEL_VARIANT_HPP_
@@ -1,18 +1,23 @@
 #ifndef WAYPOINTS_HPP_
 #define WAYPOINTS_HPP_
 
+#include <cstring>
+
 /**
  * @brief Waypoints reward model
  */
-class waypoints : public reward_model {
+class waypoints final : public reward_model {
 public:
-    std::vector<circle> wp; ///< Waypoints
+    std::shared_ptr<std::vector<circle>> wp; ///< Waypoints, shared by the copies of the model until one of them removes a waypoint
     double wp_value; ///< Reward when reaching a waypoint
 
     /**
      * @brief Constructor
      */
-    waypoints(std::vector<circle> _wp, double _wp_value) : wp(_wp), wp_value(_wp_value) {}
+    waypoints(std::vector<circle> _wp, double _wp_value) :
+        wp(std::make_shared<std::vector<circle>>(std::move(_wp))),
+        wp_value(_wp_value)
+    {}
 
     /**
      * @brief Is waypoint reached
@@ -22,7 +27,7 @@ public:
      * @return Return true if at least one waypoint is reached at the given state.
      */
     bool is_waypoint_reached(const state &s) const {
-        for(auto &w : wp) {
+        for(auto &w : *wp) {
             if(w.is_within(s.x,s.y)) {
                 return true;
             }
@@ -57,20 +62,22 @@ public:
     /**
      * @brief Remove waypoints at given position
      *
-     * Remove all the waypoints at the position of the input state.
+     * Remove all the waypoints at the position of the input state, the waypoints being
+     * copied first if they are shared with another model.
      * @param {const state &} s; input state
      * @return Return the number of removed waypoints.
      */
     unsigned remove_waypoints_at(const state &s) {
+        std::vector<circle> &own_wp = get_unshared(wp);
         std::vector<unsigned> indices_buffer;
         unsigned counter = 0;
-        for(unsigned i=0; i<wp.size(); ++i) { // Goal checking
-            if(wp[i].is_within(s.x, s.y)) {
+        for(unsigned i=0; i<own_wp.size(); ++i) { // Goal checking
+            if(own_wp[i].is_within(s.x, s.y)) {
                 ++counter;
                 indices_buffer.push_back(i);
             }
         }
-        remove_elements(wp,indices_buffer);
+        remove_elements(own_wp,indices_buffer);
         return counter;
     }
 
@@ -94,12 +101,48 @@ public:
      */
     bool is_terminal(const state &s) const {
         (void) s;
-        if(wp.size() == 0) {
+        if(wp->size() == 0) {
             return true;
         }
         return false;
     }
 
+    /**
+     * @brief Get signature
+     *
+     * Hash of the remaining waypoints.
+     * @return Return the signature.
+     */
+    std::uint64_t get_signature() const override {
+        std::uint64_t h = wp->size();
+        for(auto &w : *wp) {
+            std::uint64_t x = 0, y = 0;
+            std::memcpy(&x,&std::get<0>(w.center),sizeof(x));
+            std::memcpy(&y,&std::get<1>(w.center),sizeof(y));
+            h = h * 0x100000001b3ULL ^ x;
+            h = h * 0x100000001b3ULL ^ y;
+        }
+        return h;
+    }
+
+    /**
+     * @brief Get maximum reward within
+     *
+     * The waypoints are only removed by the updates, hence the reward is zero out of the
+     * reach of the remaining ones.
+     * @param {const state &} s; given state
+     * @param {double} reach; distance to the given state
+     * @return Return the bound.
+     */
+    double get_max_reward_within(const state &s, double reach) const override {
+        for(auto &w : *wp) {
+            if(hypot(std::get<0>(w.center) - s.x, std::get<1>(w.center) - s.y) <= w.radius + reach) {
+                return fabs(wp_value);
+            }
+        }
+        return 0.;
+    }
+
     /**
      * @brief Reward backup
      *
@@ -57,4 +57,19 @@ struct call_to_generic_shape_exception : std::exception {
     }
 };
 
+/**
+ * @brief Unbounded shared tree
+ *
+ * Exception for a shared tree searched under a decision time limit without a maximum
+ * number of records.
+ */
+struct unbounded_shared_tree_exception : std::exception {
+    explicit unbounded_shared_tree_exception() noexcept {}
+    virtual ~unbounded_shared_tree_exception() noexcept {}
+
+    virtual const char * what() const noexcept override {
+        return "in config file: a shared tree with a decision time limit needs max_tree_records.\n";
+    }
+};
+
 #endif // EXCEPTIONS_HPP_
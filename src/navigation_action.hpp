@@ -46,6 +46,29 @@ public:
         s.y += s.v * sin(s.theta);
     }
 
+    /**
+     * @brief Get speed bound
+     *
+     * The velocity only increases if the factor is above 1, up to the maximum velocity, and
+     * is otherwise at most the greater of the current and the minimum velocity, provided
+     * that 0 <= vmin <= vmax.
+     * @return Return the speed bound.
+     */
+    double get_speed_bound() const override {
+        return (fv > 1.) ? vmax : vmin;
+    }
+
+    /**
+     * @brief Get kinematics
+     *
+     * @param {action_kinematics &} k; kinematics
+     * @return Return true.
+     */
+    bool get_kinematics(action_kinematics &k) const override {
+        k = {fv,vmin,vmax,1.,dtheta,cos(dtheta),sin(dtheta),0.,0.};
+        return true;
+    }
+
     /**
      * @brief Set to default
      *
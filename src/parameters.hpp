@@ -15,6 +15,7 @@
 #include <reward_model.hpp>
 #include <waypoints.hpp>
 #include <heatmap.hpp>
+#include <reward_model_variant.hpp>
 #include <shape.hpp>
 #include <state.hpp>
 
@@ -36,6 +37,7 @@ public:
     std::string TRAJECTORY_OUTPUT_PATH;
     // Simulation parameters:
     unsigned SIMULATION_LIMIT_TIME;
+    bool IS_PLANNING_PIPELINED;
     unsigned POLICY_SELECTOR;
     unsigned DEFAULT_POLICY_SELECTOR;
     unsigned ACTIONS_SELECTOR;
@@ -49,8 +51,31 @@ public:
     // Policy parameters:
     bool IS_MODEL_DYNAMIC;
     unsigned TREE_SEARCH_BUDGET;
+    unsigned MAX_TREE_RECORDS;
+    double DECISION_TIME_LIMIT;
+    unsigned EARLY_STOP_PERIOD;
+    double EARLY_STOP_Z;
+    double PW_COEFFICIENT;
+    double PW_EXPONENT;
+    bool PW_HEURISTIC_ORDERING;
+    double DPW_COEFFICIENT;
+    double DPW_EXPONENT;
     unsigned DEFAULT_POLICY_HORIZON;
+    double ROLLOUT_TRUNCATION_EPSILON;
     unsigned MCTS_STRATEGY_SWITCH;
+    bool USE_TRANSPOSITION_TABLE;
+    double STATE_ABSTRACTION_STEP_X;
+    double STATE_ABSTRACTION_STEP_Y;
+    double STATE_ABSTRACTION_STEP_V;
+    double STATE_ABSTRACTION_STEP_THETA;
+    bool REUSE_TREE;
+    bool PONDER;
+    unsigned NB_THREADS;
+    bool SHARED_TREE;
+    double VIRTUAL_LOSS;
+    unsigned NB_LEAF_ROLLOUTS;
+    unsigned ROLLOUT_CACHE_CAPACITY;
+    unsigned ROLLOUT_BATCH_SIZE;
     double UCT_CST;
     double LIPSCHITZ_Q;
     double DISCOUNT_FACTOR;
@@ -245,18 +270,20 @@ public:
         catch(const libconfig::ParseException &e) {
             display_libconfig_parse_exception(e);
         }
-        v.reserve(5);
-        bool b0, b1, b2, b3, b4;
+        v.reserve(6);
+        bool b0, b1, b2, b3, b4, b5;
         if(cfg.lookupValue("b0",b0)
         && cfg.lookupValue("b1",b1)
         && cfg.lookupValue("b2",b2)
         && cfg.lookupValue("b3",b3)
-        && cfg.lookupValue("b4",b4)) {
+        && cfg.lookupValue("b4",b4)
+        && cfg.lookupValue("b5",b5)) {
             v.push_back(b0);
             v.push_back(b1);
             v.push_back(b2);
             v.push_back(b3);
             v.push_back(b4);
+            v.push_back(b5);
         } else {
             throw wrong_syntax_configuration_file_exception();
         }
@@ -344,9 +371,9 @@ public:
     /**
      * @brief Parse reward model
      *
-     * @param {reward_model &} rmodel; reward model
+     * @param {reward_model_variant &} rmodel; reward model
      */
-    void parse_reward_model(std::unique_ptr<reward_model> &rmodel) const {
+    void parse_reward_model(reward_model_variant &rmodel) const {
         libconfig::Config world_cfg;
         try {
             world_cfg.readFile(WORLD_PATH.c_str());
@@ -384,7 +411,7 @@ public:
                         throw wrong_syntax_configuration_file_exception();
                     }
                 }
-                rmodel = std::unique_ptr<reward_model>(new heatmap(rfield));
+                rmodel = reward_model_variant(heatmap(rfield));
                 break;
             }
             default: { // waypoints reward model
@@ -408,7 +435,7 @@ public:
                         throw wrong_syntax_configuration_file_exception();
                     }
                 }
-                rmodel = std::unique_ptr<reward_model>(new waypoints(wp,value));
+                rmodel = reward_model_variant(waypoints(wp,value));
             }
         }
     }
@@ -429,6 +456,7 @@ public:
             display_libconfig_parse_exception(e);
         }
         if(cfg.lookupValue("simulation_limit_time",SIMULATION_LIMIT_TIME)
+        && cfg.lookupValue("is_planning_pipelined",IS_PLANNING_PIPELINED)
         && cfg.lookupValue("world_path",WORLD_PATH)
         && cfg.lookupValue("trajectory_output_path",TRAJECTORY_OUTPUT_PATH)
         && cfg.lookupValue("is_crash_terminal",IS_CRASH_TERMINAL)
@@ -442,8 +470,31 @@ public:
         && cfg.lookupValue("policy_selector",POLICY_SELECTOR)
         && cfg.lookupValue("default_policy_selector",DEFAULT_POLICY_SELECTOR)
         && cfg.lookupValue("tree_search_budget",TREE_SEARCH_BUDGET)
+        && cfg.lookupValue("max_tree_records",MAX_TREE_RECORDS)
         && cfg.lookupValue("default_policy_horizon",DEFAULT_POLICY_HORIZON)
+        && cfg.lookupValue("rollout_truncation_epsilon",ROLLOUT_TRUNCATION_EPSILON)
         && cfg.lookupValue("mcts_strategy_switch",MCTS_STRATEGY_SWITCH)
+        && cfg.lookupValue("use_transposition_table",USE_TRANSPOSITION_TABLE)
+        && cfg.lookupValue("state_abstraction_step_x",STATE_ABSTRACTION_STEP_X)
+        && cfg.lookupValue("state_abstraction_step_y",STATE_ABSTRACTION_STEP_Y)
+        && cfg.lookupValue("state_abstraction_step_v",STATE_ABSTRACTION_STEP_V)
+        && cfg.lookupValue("state_abstraction_step_theta",STATE_ABSTRACTION_STEP_THETA)
+        && cfg.lookupValue("reuse_tree",REUSE_TREE)
+        && cfg.lookupValue("ponder",PONDER)
+        && cfg.lookupValue("nb_threads",NB_THREADS)
+        && cfg.lookupValue("shared_tree",SHARED_TREE)
+        && cfg.lookupValue("virtual_loss",VIRTUAL_LOSS)
+        && cfg.lookupValue("nb_leaf_rollouts",NB_LEAF_ROLLOUTS)
+        && cfg.lookupValue("rollout_cache_capacity",ROLLOUT_CACHE_CAPACITY)
+        && cfg.lookupValue("rollout_batch_size",ROLLOUT_BATCH_SIZE)
+        && cfg.lookupValue("decision_time_limit",DECISION_TIME_LIMIT)
+        && cfg.lookupValue("early_stop_period",EARLY_STOP_PERIOD)
+        && cfg.lookupValue("early_stop_z",EARLY_STOP_Z)
+        && cfg.lookupValue("pw_coefficient",PW_COEFFICIENT)
+        && cfg.lookupValue("pw_exponent",PW_EXPONENT)
+        && cfg.lookupValue("pw_heuristic_ordering",PW_HEURISTIC_ORDERING)
+        && cfg.lookupValue("dpw_coefficient",DPW_COEFFICIENT)
+        && cfg.lookupValue("dpw_exponent",DPW_EXPONENT)
         && cfg.lookupValue("uct_cst",UCT_CST)
         && cfg.lookupValue("lipschitz_q",LIPSCHITZ_Q)
         && cfg.lookupValue("discount_factor",DISCOUNT_FACTOR)
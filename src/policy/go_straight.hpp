@@ -8,13 +8,16 @@
  */
 class go_straight {
 public:
+    static constexpr bool is_deterministic = true; ///< The action only depends on the state
+    std::shared_ptr<action> straight; ///< Go-straight action, built once and shared by every call
+
     /**
      * @brief Constructor
      *
      * Construct wrt the given parameters.
      * @param {const parameters &} p; parameters
      */
-    go_straight(const parameters &p) {
+    go_straight(const parameters &p) : straight(new navigation_action(1.,100.,0.,0.)) {
         (void) p;
     }
 
@@ -23,13 +26,65 @@ public:
      *
      * Policy operator for the undertaken action at given state.
      * @param {const state &} s; given state
-     * @return Return the undertaken action at s.
+     * @return Return a reference to the undertaken action at s, valid as long as the policy.
      */
-	std::shared_ptr<action> operator()(const state &s) {
+	const std::shared_ptr<action> &operator()(const state &s) {
         (void) s;
-        return std::shared_ptr<action>(new navigation_action(1.,100.,0.,0.));
+        return straight;
 	}
 
+    /**
+     * @brief Get speed bound
+     *
+     * Speed bound of the actions of the policy, see 'action::get_speed_bound'.
+     * @return Return the speed bound.
+     */
+    double get_speed_bound() const {
+        return straight->get_speed_bound();
+    }
+
+    /**
+     * @brief Search
+     *
+     * Same as the policy operator, the policy having no model to update.
+     * @param {const state &} s; state of the agent
+     * @return Return the undertaken action at s.
+     */
+    std::shared_ptr<action> search(const state &s) {
+        return (*this)(s);
+    }
+
+    /**
+     * @brief Update model
+     *
+     * Nothing to do, the policy has no model.
+     * @param {const state &} s; current state of the agent
+     */
+    void update_model(const state &s) {
+        (void) s;
+    }
+
+    /**
+     * @brief Discard search
+     *
+     * Nothing to do, the policy keeps no search.
+     */
+    void discard_search() {}
+
+    /**
+     * @brief Stop search
+     *
+     * Nothing to do, the policy does not search.
+     */
+    void stop_search() {}
+
+    /**
+     * @brief Clear stop
+     *
+     * Nothing to do, the policy does not search.
+     */
+    void clear_stop() {}
+
     /**
      * @brief Process reward
      *
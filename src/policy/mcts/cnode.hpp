@@ -1,57 +1,36 @@
 #ifndef CNODE_HPP_
 #define CNODE_HPP_
 
-class dnode; // forward declaration
-
 /**
  * @brief Chance node class
+ *
+ * Record stored in the contiguous chance node pool of a 'mcts_tree'.
+ * The hot statistics (number of visits, mean and M2 of the sampled returns) are not stored
+ * here but in the structure-of-arrays of the tree, at the same indice.
  */
 class cnode {
 public:
-    state s; ///< Labelling state
-    std::shared_ptr<action> a; ///< Labelling action
-    std::vector<std::unique_ptr<dnode>> children; ///< Child nodes
-    std::vector<double> sampled_returns; ///< Sampled returns
-    double depth; ///< Depth
+    node_index parent; ///< Indice of the parent decision node, labelling the state
+    unsigned action; ///< Indice of the labelling action in the model's action space
+    node_index first_outcome; ///< Indice of the first outcome edge (NULL_INDEX if none)
+    atomic_value<unsigned> nb_outcomes; ///< Number of outcome edges
+    unsigned depth; ///< Depth
 
     /**
      * @brief Constructor
      */
     cnode(
-        state _s,
-        std::shared_ptr<action> _a,
-        double _depth = 0) :
-        s(_s),
-        a(_a),
+        node_index _parent = NULL_INDEX,
+        unsigned _action = 0,
+        unsigned _depth = 0) :
+        parent(_parent),
+        action(_action),
+        first_outcome(NULL_INDEX),
+        nb_outcomes(0),
         depth(_depth)
     {
         //
     }
-
-    dnode * get_last_child() const {
-        return children.back().get();
-    }
-
-    /**
-     * @brief Get number of visits
-     *
-     * Get the number of visits.
-     * @return Return the number of visits of the node.
-     */
-    unsigned get_nb_visits() const {
-        return sampled_returns.size();
-    }
-
-    /**
-     * @brief Get value
-     *
-     * Get the value of the node.
-     * This is the mean of the sampled returns.
-     * @return Return the value of the node.
-     */
-    double get_value() const {
-        return std::accumulate(sampled_returns.begin(),sampled_returns.end(),0.0) / ((double) get_nb_visits());
-    }
 };
 
 #endif // CNODE_HPP_
@@ -1,83 +1,54 @@
 #ifndef DNODE_HPP_
 #define DNODE_HPP_
 
-#include<mcts/cnode.hpp>
-
 /**
  * @brief Decision node class
+ *
+ * Record stored in the contiguous decision node pool of a 'mcts_tree'.
+ * The available actions are a slice of the action pool of the tree; the children are a
+ * contiguous block of the chance node pool, reserved at the first expansion, the ith
+ * child being labelled by the ith action of the slice.
+ * The slice holds every action of the model at the creation of the node, the invalid ones
+ * being dropped as they are drawn (see 'mcts_tree::create_child'); a node evaluated once
+ * thus only tests the validity of the action of its single child.
+ * The numbers of children and of actions are atomic so that a fully expanded node can be
+ * detected without locking when the tree is shared by several threads.
  */
 class dnode {
 public:
     state s; ///< Labelling state
-    std::vector<std::shared_ptr<action>> actions; ///< Available actions, iteratively removed
-    std::vector<std::unique_ptr<cnode>> children; ///< Child nodes
-    double depth; ///< Depth
+    unsigned first_action; ///< Indice of the first available action in the action pool
+    atomic_value<unsigned> nb_actions; ///< Number of available actions, decreased as invalid actions are dropped
+    node_index first_child; ///< Indice of the first child chance node (NULL_INDEX if none)
+    atomic_value<unsigned> nb_children; ///< Number of created children, published last
+    unsigned depth; ///< Depth
 
     /**
      * @brief Constructor
      */
     dnode(
-        state _s,
-        std::vector<std::shared_ptr<action>> _actions,
-        double _depth = 0) :
+        state _s = state(),
+        unsigned _first_action = 0,
+        unsigned _nb_actions = 0,
+        unsigned _depth = 0) :
         s(_s),
-        actions(_actions),
+        first_action(_first_action),
+        nb_actions(_nb_actions),
+        first_child(NULL_INDEX),
+        nb_children(0),
         depth(_depth)
     {
         //
     }
 
-    /**
-     * @brief Create Child
-     *
-     * Create a child (hence a chance node).
-     * The action of the child is randomly selected.
-     * @return Return the sampled action.
-     * @warning Remove the sampled action from the actions vector.
-     */
-    std::shared_ptr<action> create_child() {
-        unsigned indice = rand_indice(actions);
-        std::shared_ptr<action> sampled_action = actions.at(indice);
-        actions.erase(actions.begin() + indice);
-        children.emplace_back(std::unique_ptr<cnode>(new cnode(s,sampled_action,depth)));
-        return sampled_action;
-    }
-
-    /**
-     * @brief Get children values
-     *
-     * Get an ordered vector containing all the values of the children.
-     * * @return Return the vector containing all the children values.
-     */
-    std::vector<double> get_children_values() const {
-        std::vector<double> children_values;
-        for(auto &c : children) {
-            children_values.emplace_back(c->get_value());
-        }
-        return children_values;
-    }
-
-    /**
-     * @brief Get value
-     *
-     * Get the value of the node.
-     * This is the maximum value of its children.
-     * @return Return the value of the node.
-     */
-    double get_value() const {
-        std::vector<double> children_values = get_children_values();
-        return children.at(argmax(children_values))->get_value();
-    }
-
     /**
      * @brief Is fully expanded
      *
      * Test whether the node is fully expanded ie if every actions have been sampled.
-     * Node is a leaf.
      * @return Return a boolean answer to the test.
      */
     bool is_fully_expanded() const {
-        return (actions.size() == 0);
+        return nb_children == nb_actions;
     }
 };
 
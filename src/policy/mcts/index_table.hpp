@@ -0,0 +1,139 @@
+#ifndef INDEX_TABLE_HPP_
+#define INDEX_TABLE_HPP_
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Index table
+ *
+ * Open addressing hash multimap from a (hash, owner) key to node indices.
+ * Several values may share a key: 'find' enumerates them and returns the first one
+ * accepted by the given predicate, which is in charge of the exact comparison.
+ * Entries are stamped with a generation number so that clearing the table is O(1).
+ */
+class index_table {
+public:
+    /**
+     * @brief Entry of the table
+     */
+    class entry {
+    public:
+        std::uint64_t key; ///< Hash value
+        node_index owner; ///< Owner of the entry e.g. parent chance node
+        node_index value; ///< Stored node indice
+        unsigned generation; ///< Generation at insertion, the entry is free if outdated
+    };
+
+    std::vector<entry> entries; ///< Slots, the size is a power of 2
+    unsigned generation; ///< Current generation
+    unsigned nb_entries; ///< Number of entries of the current generation
+
+    /**
+     * @brief Constructor
+     */
+    index_table() : entries(16,entry{0,NULL_INDEX,NULL_INDEX,0}), generation(1), nb_entries(0) {}
+
+    /**
+     * @brief Clear
+     *
+     * Remove every entry by incrementing the generation.
+     */
+    void clear() {
+        nb_entries = 0;
+        if(++generation == 0) { // generation wrap-around, hardly ever reached
+            for(auto &e : entries) {
+                e.generation = 0;
+            }
+            generation = 1;
+        }
+    }
+
+    /**
+     * @brief Slot
+     *
+     * @param {std::uint64_t} key; hash value
+     * @param {node_index} owner; owner of the entry
+     * @return Return the first slot of the probing sequence of the key.
+     */
+    unsigned slot(std::uint64_t key, node_index owner) const {
+        return hash_combine(key,owner) & (entries.size() - 1);
+    }
+
+    /**
+     * @brief Insert
+     *
+     * Insert a value, the table grows when half full.
+     * @param {std::uint64_t} key; hash value
+     * @param {node_index} owner; owner of the entry
+     * @param {node_index} value; stored node indice
+     */
+    void insert(std::uint64_t key, node_index owner, node_index value) {
+        if(2 * (nb_entries + 1) > entries.size()) {
+            grow();
+        }
+        unsigned mask = entries.size() - 1;
+        unsigned i = slot(key,owner);
+        while(entries[i].generation == generation) { // linear probing
+            i = (i + 1) & mask;
+        }
+        entries[i] = entry{key,owner,value,generation};
+        ++nb_entries;
+    }
+
+    /**
+     * @brief Find
+     *
+     * Find a value stored with the given key and owner and accepted by the predicate.
+     * @param {std::uint64_t} key; hash value
+     * @param {node_index} owner; owner of the entry
+     * @param {F} is_match; predicate taking a node indice
+     * @return Return the found value, NULL_INDEX if none.
+     */
+    template <class F>
+    node_index find(std::uint64_t key, node_index owner, F is_match) const {
+        unsigned mask = entries.size() - 1;
+        for(unsigned i = slot(key,owner); entries[i].generation == generation; i = (i + 1) & mask) {
+            const entry &e = entries[i];
+            if(e.key == key && e.owner == owner && is_match(e.value)) {
+                return e.value;
+            }
+        }
+        return NULL_INDEX;
+    }
+
+    /**
+     * @brief For each
+     *
+     * Call the input function on every entry of the current generation.
+     * @param {F} f; function taking a 'const entry &'
+     */
+    template <class F>
+    void for_each(F f) const {
+        for(auto &e : entries) {
+            if(e.generation == generation) {
+                f(e);
+            }
+        }
+    }
+
+    /**
+     * @brief Grow
+     *
+     * Double the number of slots and re-insert the entries of the current generation.
+     */
+    void grow() {
+        std::vector<entry> old(entries.size() * 2,entry{0,NULL_INDEX,NULL_INDEX,0});
+        old.swap(entries);
+        unsigned g = generation;
+        generation = 1;
+        nb_entries = 0;
+        for(auto &e : old) {
+            if(e.generation == g) {
+                insert(e.key,e.owner,e.value);
+            }
+        }
+    }
+};
+
+#endif // INDEX_TABLE_HPP_
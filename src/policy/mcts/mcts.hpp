@@ -4,12 +4,106 @@
 #include <cassert>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <numeric>
+#include <shared_mutex>
 
-#include <mcts/cnode.hpp>
-#include <mcts/dnode.hpp>
+#include <mcts/tree.hpp>
+#include <mcts/rollout_cache.hpp>
+#include <rollout_engine.hpp>
+#include <rollout_batch.hpp>
+#include <atomic_value.hpp>
+#include <deadline.hpp>
+#include <exceptions.hpp>
+#include <thread_pool.hpp>
 #include <utils.hpp>
 
+/**
+ * @brief Shared tree locks
+ *
+ * Synchronization of the threads searching a shared 'mcts_tree'.
+ * A reader-writer lock serializes the structural modifications (expansions, outcome edges
+ * and indices) while letting the lookups run concurrently; striped locks serialize the
+ * updates of the statistics of a same chance node.
+ */
+class shared_tree_locks {
+public:
+    static constexpr unsigned NB_STRIPES = 64; ///< Number of statistics locks
+    std::shared_mutex structure; ///< Lock of the structure of the tree
+    std::mutex stats[NB_STRIPES]; ///< Locks of the statistics, chance node c uses stats[c % NB_STRIPES]
+};
+
+/**
+ * @brief Search workspace
+ *
+ * Buffers of a search thread, reused from one iteration to the other so that a descent
+ * does not allocate once they have grown to their working size.
+ */
+class search_workspace {
+public:
+    /**
+     * @brief Step of a descent
+     */
+    class step {
+    public:
+        node_index c; ///< Indice of the selected chance node
+        double reward; ///< Reward of the sampled transition
+    };
+
+    /**
+     * @brief Block of UCT scores
+     *
+     * Statistics of ARGMAX_BLOCK_SIZE children of a decision node, laid out as arrays so
+     * that 'score' is a branch-free loop, which the compiler vectorizes.
+     * The lanes past the last child hold finite statistics and a -infinity bonus.
+     */
+    class uct_block {
+    public:
+        double nb_pending[ARGMAX_BLOCK_SIZE]; ///< Number of descents in progress through each child
+        double totals[ARGMAX_BLOCK_SIZE]; ///< Number of visits and descents in progress, 1 if none
+        double means[ARGMAX_BLOCK_SIZE]; ///< Mean of the sampled returns
+        double inverse_sqrts[ARGMAX_BLOCK_SIZE]; ///< 1/sqrt(total), 0 if no visit
+        double bonuses[ARGMAX_BLOCK_SIZE]; ///< infinity if no visit, -infinity past the last child, 0 otherwise
+        double scores[ARGMAX_BLOCK_SIZE]; ///< Scores of the block
+        double maxvals[ARGMAX_BLOCK_SIZE]; ///< Maximum score of each lane over the blocks
+
+        /**
+         * @brief Score
+         *
+         * Score the block and update the maximum of each lane, the descents in progress
+         * returning 'virtual_loss'.
+         * @param {double} virtual_loss; value of a descent in progress
+         * @param {double} exploration; exploration factor
+         */
+        void score(double virtual_loss, double exploration) {
+            for(unsigned k=0; k<ARGMAX_BLOCK_SIZE; ++k) {
+                double weight = nb_pending[k] / totals[k];
+                double score = means[k] + weight * (virtual_loss - means[k]) + exploration * inverse_sqrts[k] + bonuses[k];
+                scores[k] = score;
+                maxvals[k] = (score > maxvals[k]) ? score : maxvals[k];
+            }
+        }
+    };
+
+    std::vector<step> path; ///< Chance nodes selected during the current descent, from the root
+    std::vector<double> scores; ///< Scores of the children of a decision node
+    std::vector<double> weights; ///< Selection weights of the children of a decision node
+    uct_block block; ///< Block of UCT scores
+};
+
+/**
+ * @brief Deferred leaf
+ *
+ * New chance node reached by a descent whose evaluation is deferred to a rollout batch.
+ */
+class deferred_leaf {
+public:
+    search_workspace ws; ///< Buffers of the descent, holding its path
+    node_index c; ///< Indice of the new chance node, NULL_INDEX if the descent ended otherwise
+    state s; ///< Sampled state of the parent decision node
+    std::uint64_t signature; ///< Signature of the model at the leaf, for the memo of the returns
+};
+
 /**
  * @brief MCTS algorithm class
  */
@@ -21,16 +115,53 @@ public:
 
     PL default_policy; ///< Default policy
     MD model; ///< Generative model
+    mcts_tree tree; ///< Search tree, its pools are reused from one call to the other
+    mcts_tree spare_tree; ///< Second tree buffer, receives the promoted subtree when reusing the tree
+    state_quantizer quantizer; ///< State hash used to index the outcomes of the chance nodes
     bool is_model_dynamic; ///< Is the model dynamic
+    bool use_transposition_table; ///< Share the decision nodes labelled by the same state
+    bool reuse_tree; ///< Keep the subtree of the observed outcome from one decision to the next
+    node_index root_choice; ///< Chance node of the last recommended action, NULL_INDEX if none
     double discount_factor; ///< Discount factor
     double uct_parameter; ///< UCT parameter
     double lipschitz_q; ///< Lipschitz constant for Q-values
     double terminal_state_value = 0.; ///< Terminal state value
+    double virtual_loss; ///< Return assumed for the descents in progress in a shared tree search
     unsigned budget; ///< Budget ie number of expanded nodes in the tree
-    unsigned nb_cnodes; ///< Number of expanded nodes
-    unsigned nb_calls; ///< Number of calls to the generative model
+    unsigned max_nb_records; ///< Maximum number of records of the tree (see 'mcts_tree::get_nb_records'), 0 for no limit
+    deadline time_limit; ///< Time budget of a decision, the budget still bounds the number of iterations
+    unsigned early_stop_period; ///< Number of iterations between two tests of the stopping rule, 0 to disable
+    double early_stop_z; ///< Confidence quantile of the stopping rule
+    double nb_iterations_spent; ///< Number of search iterations run, summed over the decisions
+    atomic_value<unsigned> nb_cnodes; ///< Number of expanded nodes, counted from the tree when a search or the pondering starts
+    atomic_value<unsigned> nb_calls; ///< Number of calls to the generative model
     unsigned horizon; ///< Horizon for the default policy simulation
     unsigned mcts_strategy_switch; ///< Strategy switch for MCTS algorithm
+    node_index halving_root; ///< Root of the sequential halving in progress, NULL_INDEX if none
+    std::vector<node_index> halving_arms; ///< Root chance nodes remaining in the last sequential halving
+    double pw_coefficient; ///< Progressive widening: a decision node visited n times has at most pw_coefficient * n^pw_exponent children, 0 to disable
+    double pw_exponent; ///< Progressive widening exponent
+    double dpw_coefficient; ///< Double progressive widening: a chance node visited n times has at most dpw_coefficient * n^dpw_exponent outcomes, 0 to disable
+    double dpw_exponent; ///< Double progressive widening exponent
+    std::vector<std::pair<double,unsigned>> scored_actions; ///< Buffer of the heuristic ordering of the actions
+    unsigned nb_decisions; ///< Number of calls to the policy operator
+    double nb_reused_visits; ///< Number of visits inherited from the previous trees
+    unsigned nb_threads; ///< Number of search threads, 1 for a sequential search
+    std::vector<mcts> workers; ///< Root-parallel workers, each one searching its own tree
+    std::unique_ptr<shared_tree_locks> locks; ///< Locks of the shared tree, null unless the tree is shared
+    std::unique_ptr<thread_pool> pool; ///< Threads running the workers or searching the shared tree
+    std::vector<search_workspace> workspaces; ///< Buffers of the threads searching the tree, one per thread
+    unsigned nb_leaf_rollouts; ///< Number of default policy rollouts averaged at each leaf
+    std::unique_ptr<thread_pool> rollout_pool; ///< Threads running the rollouts of a leaf, null for a single rollout
+    rollout_engine rollouts; ///< Simulation of the default policy
+    std::unique_ptr<rollout_cache> rollout_memo; ///< Memo of the rollout returns, null unless the rollouts are deterministic
+    unsigned rollout_batch_size; ///< Number of leaves whose rollouts are simulated in lockstep by a sequential search, 0 or 1 to evaluate the leaves one by one
+    rollout_batch batch; ///< Lockstep simulation of the rollouts of the deferred leaves
+    std::vector<deferred_leaf> deferred_leaves; ///< Leaves of the current batch
+    std::vector<MD> deferred_models; ///< Models of the rollouts of the current batch, if dynamic
+    std::vector<rollout_request<MD>> batch_requests; ///< Rollouts of the current batch
+    std::unique_ptr<thread_pool> ponder_pool; ///< Thread extending the tree between two decisions, null unless pondering
+    atomic_value<bool> is_pondering; ///< Set while the tree is extended between two decisions, cleared to stop it
 
     /**
      * @brief Constructor
@@ -44,11 +175,77 @@ public:
         nb_calls = 0;
         uct_parameter = p.UCT_CST;
         lipschitz_q = p.LIPSCHITZ_Q;
+        virtual_loss = p.VIRTUAL_LOSS;
         budget = p.TREE_SEARCH_BUDGET;
+        max_nb_records = (p.MAX_TREE_RECORDS == 0) ? 0 : std::max<unsigned>(p.MAX_TREE_RECORDS,2 * model.action_space.size() + 1); // room for the root, its actions and its children
+        time_limit.duration_ms = p.DECISION_TIME_LIMIT;
+        early_stop_period = p.EARLY_STOP_PERIOD;
+        early_stop_z = p.EARLY_STOP_Z;
+        nb_iterations_spent = 0.;
         discount_factor = p.DISCOUNT_FACTOR;
         horizon = p.DEFAULT_POLICY_HORIZON;
         is_model_dynamic = p.IS_MODEL_DYNAMIC;
         mcts_strategy_switch = p.MCTS_STRATEGY_SWITCH;
+        use_transposition_table = p.USE_TRANSPOSITION_TABLE;
+        quantizer.set_abstraction(0,p.STATE_ABSTRACTION_STEP_X);
+        quantizer.set_abstraction(1,p.STATE_ABSTRACTION_STEP_Y);
+        quantizer.set_abstraction(2,p.STATE_ABSTRACTION_STEP_V);
+        quantizer.set_abstraction(3,p.STATE_ABSTRACTION_STEP_THETA);
+        reuse_tree = p.REUSE_TREE;
+        pw_coefficient = p.PW_COEFFICIENT;
+        pw_exponent = p.PW_EXPONENT;
+        dpw_coefficient = p.DPW_COEFFICIENT;
+        dpw_exponent = p.DPW_EXPONENT;
+        tree.is_expansion_ordered = p.PW_HEURISTIC_ORDERING;
+        spare_tree.is_expansion_ordered = p.PW_HEURISTIC_ORDERING;
+        root_choice = NULL_INDEX;
+        halving_root = NULL_INDEX;
+        nb_decisions = 0;
+        nb_reused_visits = 0.;
+        nb_threads = std::max(1u,p.NB_THREADS);
+        if(nb_threads > 1 && p.SHARED_TREE) { // tree parallelization
+            if(p.DECISION_TIME_LIMIT > 0 && p.MAX_TREE_RECORDS == 0) { // the pools are reserved for the whole budget
+                throw unbounded_shared_tree_exception();
+            }
+            locks.reset(new shared_tree_locks());
+            pool.reset(new thread_pool(nb_threads - 1));
+        } else if(nb_threads > 1) { // root parallelization, the budget is shared among the workers
+            parameters wp = p;
+            wp.NB_THREADS = 1;
+            wp.TREE_SEARCH_BUDGET = std::max(1u,budget / nb_threads);
+            wp.MAX_TREE_RECORDS = p.MAX_TREE_RECORDS / nb_threads;
+            workers.reserve(nb_threads);
+            for(unsigned i=0; i<nb_threads; ++i) {
+                workers.emplace_back(wp);
+            }
+            pool.reset(new thread_pool(nb_threads - 1));
+        }
+        workspaces.resize(locks ? nb_threads : 1);
+        nb_leaf_rollouts = std::max(1u,p.NB_LEAF_ROLLOUTS);
+        if(nb_leaf_rollouts > 1) { // leaf parallelization
+            rollout_pool.reset(new thread_pool(nb_leaf_rollouts - 1));
+        }
+        rollouts = rollout_engine(discount_factor,horizon,is_model_dynamic,p.ROLLOUT_TRUNCATION_EPSILON);
+        if(p.ROLLOUT_CACHE_CAPACITY > 0 && PL::is_deterministic
+        && model.misstep_probability <= 0. && model.state_gaussian_stddev <= 0.) { // deterministic rollouts
+            rollout_memo.reset(new rollout_cache(p.ROLLOUT_CACHE_CAPACITY));
+        }
+        rollout_batch_size = (locks || !rollout_batch::is_supported(model)) ? 0 : p.ROLLOUT_BATCH_SIZE;
+        is_pondering = false;
+        if(p.PONDER && reuse_tree && workers.empty()) { // the workers of a root-parallel search ponder on their own
+            ponder_pool.reset(new thread_pool(1));
+        }
+    }
+
+    mcts(mcts &&) = default;
+
+    /**
+     * @brief Destructor
+     *
+     * Stop the pondering, if any.
+     */
+    ~mcts() {
+        stop_pondering();
     }
 
     /**
@@ -70,41 +267,73 @@ public:
     /**
      * @brief Sample return
      *
-     * Sample a return with the default policy starting at the input state.
-     * @param {state} s; input state
+     * Sample a return with the default policy starting at the sampled state of the parent
+     * of the input chance node, the first action being the labelling action of the node.
+     * With several leaf rollouts, the rollouts run in parallel, from copies of the model if
+     * dynamic, and their mean is returned.
+     * Deterministic rollouts are run once and their return is memoized.
+     * @param {node_index} c; indice of the chance node
+     * @param {const state &} s; sampled state of the parent decision node
+     * @param {MD &} mod; model
      * @return Return the sampled return.
      */
-    double sample_return(cnode * ptr, MD &mod) {
-        if(mod.is_terminal(ptr->s)) {
+    double sample_return(node_index c, const state &s, MD &mod) {
+        if(mod.is_terminal(s)) {
             return terminal_state_value;
         }
-        double total_return = 0.;
-        state s = ptr->s;
-        std::shared_ptr<action> a = ptr->a;
-        for(unsigned t=0; t<horizon; ++t) {
-            state s_p = generative_model(s,a,mod);
-            total_return += pow(discount_factor,(double)t) * mod.reward_function(s,a,s_p);
-            if(is_model_dynamic) {
-                mod.step(s_p);
+        const std::shared_ptr<action> &a = mod.action_space[tree.cnodes[c].action];
+        if(rollout_memo) {
+            std::uint64_t signature = mod.get_signature(); // before the rollout updates the model
+            double q;
+            if(!rollout_memo->find(s,tree.cnodes[c].action,signature,q)) {
+                q = rollout(s,a,mod);
+                rollout_memo->insert(s,tree.cnodes[c].action,signature,q);
             }
-            if(mod.is_terminal(s_p)) {
-                break;
-            }
-            s = s_p;
-            a = default_policy(s);
+            return q;
         }
-        return total_return;
+        if(!rollout_pool) {
+            return rollout(s,a,mod);
+        }
+        std::vector<double> returns(nb_leaf_rollouts);
+        rollout_pool->seeded_parallel_for(nb_leaf_rollouts,[&](unsigned k) {
+            if(is_model_dynamic) {
+                MD rollout_model(mod);
+                returns[k] = rollout(s,a,rollout_model);
+            } else {
+                returns[k] = rollout(s,a,mod);
+            }
+        });
+        return std::accumulate(returns.begin(),returns.end(),0.) / ((double) nb_leaf_rollouts);
     }
 
     /**
-     * @brief Update value
+     * @brief Evaluate state
      *
-     * Update the value of a chance node by stacking a new sampled value.
-     * @param {cnode *} ptr; pointer to the updated chance node
-     * @param {double} q; new sampled value
+     * Sample a return with the default policy starting at a non-terminal state that could
+     * not be added to the full tree.
+     * @param {const state &} s; state
+     * @param {MD &} mod; model
+     * @return Return the sampled return.
      */
-    void update_value(cnode * ptr, double q) const {
-        ptr->sampled_returns.push_back(q);
+    double evaluate_state(const state &s, MD &mod) {
+        return rollout(s,default_policy(s),mod);
+    }
+
+    /**
+     * @brief Rollout
+     *
+     * Run the default policy and compute the discounted return, each simulated step
+     * counting as a call to the generative model.
+     * @param {const state &} s; starting state
+     * @param {const std::shared_ptr<action> &} a; first action
+     * @param {MD &} mod; model, updated along the rollout if dynamic
+     * @return Return the sampled return.
+     */
+    double rollout(const state &s, const std::shared_ptr<action> &a, MD &mod) {
+        unsigned nb_steps = 0;
+        double total_return = rollouts.run(s,a,mod,default_policy,nb_steps);
+        nb_calls += nb_steps;
+        return total_return;
     }
 
     /**
@@ -112,42 +341,110 @@ public:
      *
      * Select child of a decision node wrt the MCTS strategy.
      * The node must be fully expanded.
-     * @param {dnode *} v; decision node
-     * @return Return to the select child, which is a chance node.
+     * @param {node_index} v; indice of the decision node
+     * @return Return the indice of the selected child, which is a chance node.
+     */
+    node_index mcts_strategy(node_index v) const {
+        const dnode &d = tree.dnodes[v];
+        return d.first_child + rand_unsigned() % d.nb_children;
+    }
+
+    /**
+     * @brief Exploration factor
+     *
+     * Factor of the exploration term of the UCT score, common to every child of a node.
+     * @return Return 2 * uct_parameter * sqrt(log(nb_cnodes)).
+     */
+    double exploration_factor() const {
+        return 2 * uct_parameter * sqrt(log((double) nb_cnodes));
+    }
+
+    /**
+     * @brief UCT score
+     *
+     * Compute the UCT score of a chance node, the exploration term being the exploration
+     * factor times 1/sqrt(number of visits), read from a precomputed table.
+     * The descents in progress through the node count as visits returning 'virtual_loss',
+     * so that the threads searching a shared tree spread over different branches.
+     * @param {node_index} c; indice of the chance node
+     * @param {double} exploration; exploration factor
+     * @return Return the score.
      */
-    cnode * mcts_strategy(dnode * v) const {
-        return v->children.at(rand_indice(v->children)).get();
+    double uct_score(node_index c, double exploration) const {
+        unsigned nb_visits = tree.visits[c];
+        unsigned nb_pending = tree.pending[c];
+        double value = tree.get_value(c);
+        if(nb_pending > 0) {
+            value = (value * nb_visits + virtual_loss * nb_pending) / ((double) (nb_visits + nb_pending));
+        }
+        return value + exploration * inverse_sqrt(nb_visits + nb_pending);
     }
 
     /**
      * @brief UCT scores
      *
-     * Compute the UCT scores of the given vector of chance nodes.
-     * @param {const std::vector<std::unique_ptr<cnode>> &} cv; input vector
-     * @return Return a vector containing the scores of the given vector of chance nodes.
+     * Compute the UCT scores of the children of the given decision node.
+     * @param {node_index} v; indice of the decision node
+     * @param {std::vector<double> &} scores; buffer set to the scores of the children, in order
      */
-    std::vector<double> uct_scores(const std::vector<std::unique_ptr<cnode>> &cv) const {
-        std::vector<double> scores;
-        for(auto &c : cv) {
-            scores.emplace_back(
-                c->get_value()
-                + 2 * uct_parameter *
-                sqrt(log((double) nb_cnodes) / ((double) c->get_nb_visits()))
-            );
+    void uct_scores(node_index v, std::vector<double> &scores) const {
+        const dnode &d = tree.dnodes[v];
+        double exploration = exploration_factor();
+        scores.clear();
+        for(node_index c = d.first_child; c < d.first_child + d.nb_children; ++c) {
+            scores.emplace_back(uct_score(c,exploration));
         }
-        return scores;
     }
 
     /**
      * @brief UCT strategy
      *
-     * Select child of a decision node wrt the UCT strategy.
-     * The node must be fully expanded.
-     * @param {dnode *} v; decision node
-     * @return Return to the select child, which is a chance node.
+     * Select child of a decision node wrt the UCT strategy, the scores being those of
+     * 'uct_score' up to rounding.
+     * The statistics of the children are loaded from the arrays of the tree by blocks of
+     * ARGMAX_BLOCK_SIZE into the workspace, then scored and reduced to their maximum by the
+     * branch-free loop of 'uct_block::score'; the ties are broken by 'argmax_of_blocks'.
+     * Nothing is allocated once the buffers of the workspace have grown.
+     * @param {node_index} v; indice of the decision node
+     * @param {search_workspace &} ws; buffers of the calling thread
+     * @return Return the indice of the selected child, which is a chance node.
      */
-    cnode * uct_strategy(dnode * v) const {
-        return v->children.at(argmax(uct_scores(v->children))).get();
+    node_index uct_strategy(node_index v, search_workspace &ws) const {
+        constexpr unsigned B = ARGMAX_BLOCK_SIZE;
+        constexpr double INF = std::numeric_limits<double>::infinity();
+        const dnode &d = tree.dnodes[v];
+        unsigned n = d.nb_children;
+        double exploration = exploration_factor();
+        search_workspace::uct_block &blk = ws.block;
+        ws.scores.resize((n + B - 1) / B * B);
+        std::fill(blk.maxvals,blk.maxvals + B,-INF);
+        for(unsigned b=0; b<n; b+=B) {
+            for(unsigned k=0; k<B; ++k) { // load
+                if(b + k < n) {
+                    node_index c = d.first_child + b + k;
+                    unsigned nb_pending = tree.pending[c];
+                    unsigned total = tree.visits[c] + nb_pending;
+                    blk.nb_pending[k] = nb_pending;
+                    blk.totals[k] = (total > 0) ? total : 1;
+                    blk.means[k] = tree.means[c];
+                    blk.inverse_sqrts[k] = (total > 0) ? inverse_sqrt(total) : 0.;
+                    blk.bonuses[k] = (total > 0) ? 0. : INF;
+                } else {
+                    blk.nb_pending[k] = 0.;
+                    blk.totals[k] = 1.;
+                    blk.means[k] = 0.;
+                    blk.inverse_sqrts[k] = 0.;
+                    blk.bonuses[k] = -INF;
+                }
+            }
+            blk.score(virtual_loss,exploration);
+            std::copy(blk.scores,blk.scores + B,ws.scores.begin() + b);
+        }
+        double maxval = blk.maxvals[0];
+        for(unsigned k=1; k<B; ++k) {
+            maxval = std::max(maxval,blk.maxvals[k]);
+        }
+        return d.first_child + argmax_of_blocks(ws.scores.data(),n,maxval);
     }
 
     /**
@@ -155,18 +452,21 @@ public:
      *
      * Select child of a decision node wrt the TUCT strategy.
      * The node must be fully expanded.
-     * @param {dnode *} v; decision node
-     * @return Return to the select child, which is a chance node.
+     * @param {node_index} v; indice of the decision node
+     * @param {search_workspace &} ws; buffers of the calling thread
+     * @return Return the indice of the selected child, which is a chance node.
      */
-    cnode * tuct_strategy(dnode * v) const {
-        std::vector<double> scores = uct_scores(v->children);
+    node_index tuct_strategy(node_index v, search_workspace &ws) const {
+        uct_scores(v,ws.scores);
+        const std::vector<double> &scores = ws.scores;
         unsigned maxind = argmax(scores);
-        double delta = v->depth * lipschitz_q;
+        double delta = tree.dnodes[v].depth * lipschitz_q;
         if(are_equal(delta,0.)) {
-            return v->children.at(maxind).get();
+            return tree.dnodes[v].first_child + maxind;
         } else {
             double deltamin = scores[maxind] - delta;
-            std::vector<double> weights(scores.size(),0.);
+            std::vector<double> &weights = ws.weights;
+            weights.assign(scores.size(),0.);
             weights[maxind] = 2 * delta; // maximum weight
             for(unsigned i = 0; i < scores.size(); ++i) {
                 if(i != maxind) {
@@ -175,25 +475,49 @@ public:
                     }
                 }
             }
-            return v->children.at(pick_weighted_indice(weights)).get();
+            return tree.dnodes[v].first_child + pick_weighted_indice(weights);
         }
     }
 
+    /**
+     * @brief Halving strategy
+     *
+     * Select the root child of a sequential halving round: the remaining arm with the
+     * fewest visits, the descents in progress included, so that the round spreads its
+     * iterations evenly over the remaining arms whatever their visits inherited from a
+     * previous search.
+     * @return Return the indice of the selected child, which is a chance node.
+     */
+    node_index halving_strategy() const {
+        return halving_arms[argmax_of(halving_arms.size(),[&](unsigned i) {
+            unsigned nb_visits = tree.visits[halving_arms[i]];
+            unsigned nb_pending = tree.pending[halving_arms[i]];
+            return -((double) (nb_visits + nb_pending));
+        })];
+    }
+
     /**
      * @brief Select child
      *
      * Select child of a decision node wrt one of the implemented strategies.
      * The node must be fully expanded.
-     * @param {dnode *} v; decision node
-     * @return Return to the select child, which is a chance node.
+     * @param {node_index} v; indice of the decision node
+     * @param {search_workspace &} ws; buffers of the calling thread
+     * @return Return the indice of the selected child, which is a chance node.
      */
-    cnode * select_child(dnode * v) const {
+    node_index select_child(node_index v, search_workspace &ws) const {
         switch(mcts_strategy_switch) {
             case 0: { // UCT
-                return uct_strategy(v);
+                return uct_strategy(v,ws);
             }
             case 1: { // TUCT
-                return tuct_strategy(v);
+                return tuct_strategy(v,ws);
+            }
+            case 2: { // Sequential halving at the root, UCT below
+                if(v == halving_root && !halving_arms.empty()) {
+                    return halving_strategy();
+                }
+                return uct_strategy(v,ws);
             }
             default: { // Vanilla MCTS
                 return mcts_strategy(v);
@@ -201,147 +525,943 @@ public:
         }
     }
 
+    /**
+     * @brief Read lock
+     *
+     * @return Return a shared lock of the structure of the tree, which owns nothing
+     * unless the tree is shared.
+     */
+    std::shared_lock<std::shared_mutex> read_lock() const {
+        return locks ? std::shared_lock<std::shared_mutex>(locks->structure) : std::shared_lock<std::shared_mutex>();
+    }
+
+    /**
+     * @brief Write lock
+     *
+     * @return Return an exclusive lock of the structure of the tree, which owns nothing
+     * unless the tree is shared.
+     */
+    std::unique_lock<std::shared_mutex> write_lock() const {
+        return locks ? std::unique_lock<std::shared_mutex>(locks->structure) : std::unique_lock<std::shared_mutex>();
+    }
+
+    /**
+     * @brief Update value
+     *
+     * Update the statistics of a chance node with a sampled return and, if the tree is
+     * shared, remove the virtual loss of the descent.
+     * @param {node_index} c; indice of the chance node
+     * @param {double} q; sampled return
+     */
+    void update_value(node_index c, double q) {
+        if(locks) {
+            std::lock_guard<std::mutex> lock(locks->stats[c % shared_tree_locks::NB_STRIPES]);
+            tree.update_value(c,q);
+            --tree.pending[c];
+        } else {
+            tree.update_value(c,q);
+        }
+    }
+
+    /**
+     * @brief Is widened
+     *
+     * Test whether a decision node has as many children as allowed.
+     * Without progressive widening, this is the full expansion test; with progressive
+     * widening, a node visited n times may have ceil(pw_coefficient * n^pw_exponent)
+     * children (at least one).
+     * The root of a sequential halving is fully expanded.
+     * @param {node_index} v; indice of the decision node
+     * @return Return true if no child may be created.
+     */
+    bool is_widened(node_index v) const {
+        const dnode &d = tree.dnodes[v];
+        unsigned nb_children = d.nb_children;
+        if(nb_children == d.nb_actions) {
+            return true;
+        }
+        if(pw_coefficient <= 0. || v == halving_root) {
+            return false;
+        }
+        double n = tree.get_dnode_nb_visits(v);
+        return nb_children >= std::max(1.,std::ceil(pw_coefficient * pow(n,pw_exponent)));
+    }
+
+    /**
+     * @brief Is outcome widened
+     *
+     * Double progressive widening test: a chance node visited n times may have
+     * ceil(dpw_coefficient * n^dpw_exponent) outcomes (at least one), an existing outcome
+     * being revisited beyond.
+     * The test is made without lock, concurrent descents may exceed the limit by a few
+     * outcomes.
+     * @param {node_index} c; indice of the chance node
+     * @return Return true if no outcome may be sampled.
+     */
+    bool is_outcome_widened(node_index c) const {
+        if(dpw_coefficient <= 0.) {
+            return false;
+        }
+        unsigned nb_outcomes = tree.cnodes[c].nb_outcomes;
+        if(nb_outcomes == 0) {
+            return false;
+        }
+        double n = tree.get_nb_visits(c);
+        return nb_outcomes >= std::max(1.,std::ceil(dpw_coefficient * pow(n,dpw_exponent)));
+    }
+
+    /**
+     * @brief Order actions
+     *
+     * Order the action slice of a decision node by decreasing nominal reward, which is the
+     * expansion order when 'tree.is_expansion_ordered' is set, and drop the actions leading
+     * to a wall, unless they all do, in which case a random one is kept.
+     * Done at the first expansion of the node.
+     * The slice is shuffled first, hence the ties are broken randomly.
+     * @param {node_index} v; indice of the decision node
+     * @param {const MD &} mod; model at the node
+     */
+    void order_actions(node_index v, const MD &mod) {
+        dnode &d = tree.dnodes[v];
+        scored_actions.clear();
+        for(unsigned k = d.first_action; k < d.first_action + d.nb_actions; ++k) {
+            unsigned a = tree.actions[k];
+            if(mod.is_action_valid(d.s,mod.action_space[a])) {
+                scored_actions.emplace_back(mod.nominal_reward(d.s,mod.action_space[a]),a);
+            }
+        }
+        if(scored_actions.empty()) { // every action leads to a wall
+            scored_actions.emplace_back(0.,tree.actions[d.first_action + rand_unsigned() % d.nb_actions]);
+        }
+        for(unsigned i=scored_actions.size(); i>1; --i) { // random tie-break
+            std::swap(scored_actions[i-1],scored_actions[rand_unsigned() % i]);
+        }
+        std::stable_sort(scored_actions.begin(),scored_actions.end(),[](const auto &x, const auto &y) {
+            return x.first > y.first;
+        });
+        for(unsigned i=0; i<scored_actions.size(); ++i) {
+            tree.actions[d.first_action + i] = scored_actions[i].second;
+        }
+        d.nb_actions = scored_actions.size();
+    }
+
+    /**
+     * @brief Is tree full
+     *
+     * Test whether the tree reached its maximum number of records (see
+     * 'mcts_tree::get_nb_records'), in which case neither a decision node nor the children
+     * block of a decision node may be created; the tree may therefore exceed the maximum by
+     * the records of one decision node and of its children block.
+     * Structural test, made under the write lock in a shared tree.
+     * @return Return true if the tree is full.
+     */
+    bool is_tree_full() const {
+        return max_nb_records > 0 && tree.get_nb_records() >= max_nb_records;
+    }
+
+    /**
+     * @brief Expand
+     *
+     * Create a new child (hence a chance node) of a decision node if it has less children
+     * than allowed (see 'is_widened') and if the tree is not full or the children block of
+     * the node is already reserved.
+     * The test is made without the lock first, a positive answer being checked again under
+     * the lock.
+     * The actions are ordered at the first expansion if the expansion is ordered.
+     * @param {node_index} v; indice of the decision node
+     * @param {const MD &} mod; model at the node
+     * @return Return the indice of the created chance node, NULL_INDEX if no child may be
+     * created.
+     */
+    node_index expand(node_index v, const MD &mod) {
+        if(is_widened(v)) {
+            return NULL_INDEX;
+        }
+        auto lock = write_lock();
+        if(is_widened(v)) { // expanded meanwhile by another thread
+            return NULL_INDEX;
+        }
+        if(tree.dnodes[v].nb_children == 0) {
+            if(is_tree_full()) { // no room for the children block
+                return NULL_INDEX;
+            }
+            if(tree.is_expansion_ordered) {
+                order_actions(v,mod);
+            }
+        }
+        node_index c = tree.create_child(v,mod);
+        if(c == NULL_INDEX) { // the remaining actions lead to a wall
+            return NULL_INDEX;
+        }
+        ++nb_cnodes;
+        if(locks) { // virtual loss, removed by 'update_value'
+            ++tree.pending[c];
+        }
+        return c;
+    }
+
     /**
      * @brief Evaluate
      *
-     * Create a new child node to a decision node and sample a return value with the default
-     * policy.
-     * @param {dnode *} v; pointer to the decision node
+     * Sample a return value with the default policy at a newly created chance node.
+     * @param {node_index} c; indice of the chance node
+     * @param {const state &} s; sampled state of the parent decision node
+     * @param {MD &} mod; model
      * @return Return the sampled value.
      */
-    double evaluate(dnode * v, MD &mod) {
-        nb_cnodes++; // a chance node will be created
-        v->create_child();
-        double q = sample_return(v->children.back().get(),mod);
-        update_value(v->children.back().get(),q);
+    double evaluate(node_index c, const state &s, MD &mod) {
+        double q = sample_return(c,s,mod);
+        update_value(c,q);
         return q;
     }
 
     /**
      * @brief Is state already sampled
      *
-     * Equality operator.
-     * @param {cnode *} ptr; pointer to the chance node
-     * @param {state &} s; sampled state
-     * @param {unsigned &} ind; indice modified to the value of the indice of the existing
-     * decision node with state s if the comparison succeeds.
+     * Look for an outcome of the chance node equal to the sampled state.
+     * The outcomes are found through their hashed quantized state, the equality being then
+     * tested with 'state_quantizer::is_equivalent', hence the lookup is O(1) expected.
+     * With state abstraction, the found outcome is equivalent to the sampled state.
+     * @param {node_index} c; indice of the chance node
+     * @param {const state &} s; sampled state
+     * @param {node_index &} ind; modified to the indice of the existing decision node with
+     * state s if the comparison succeeds.
+     */
+    bool is_state_already_sampled(node_index c, const state &s, node_index &ind) const {
+        return quantizer.for_each_candidate_hash(s,COMPARISON_THRESHOLD,[&](std::uint64_t key) {
+            ind = tree.outcome_index.find(key,c,[&](node_index v) {
+                return quantizer.is_equivalent(s,tree.dnodes[v].s);
+            });
+            return ind != NULL_INDEX;
+        });
+    }
+
+    /**
+     * @brief Transposition key
+     *
+     * Key of a decision node in the transposition table.
+     * The state hash, which includes the time, is combined with the signature of the model
+     * so that nodes are only shared if the model was updated the same way along both paths.
+     * @param {std::uint64_t} state_key; hash of the state
+     * @param {const MD &} mod; model at the node
+     * @return Return the key.
+     */
+    std::uint64_t transposition_key(std::uint64_t state_key, const MD &mod) const {
+        return hash_combine(state_key,mod.get_signature());
+    }
+
+    /**
+     * @brief Find transposition
+     *
+     * Look for a decision node labelled by the given state anywhere in the tree.
+     * @param {const state &} s; state
+     * @param {const MD &} mod; model at the state
+     * @return Return the indice of the found decision node, NULL_INDEX if none.
      */
-    bool is_state_already_sampled(cnode * ptr, state &s, unsigned &ind) const {
-        for(unsigned i=0; i<ptr->children.size(); ++i) {
-            if(s.is_equal_to(ptr->children[i]->s)) {
-                ind = i;
-                return true;
+    node_index find_transposition(const state &s, const MD &mod) const {
+        node_index ind = NULL_INDEX;
+        quantizer.for_each_candidate_hash(s,COMPARISON_THRESHOLD,[&](std::uint64_t key) {
+            ind = tree.transpositions.find(transposition_key(key,mod),NULL_INDEX,[&](node_index v) {
+                return quantizer.is_equivalent(s,tree.dnodes[v].s);
+            });
+            return ind != NULL_INDEX;
+        });
+        return ind;
+    }
+
+    /**
+     * @brief Add decision node
+     *
+     * Create a decision node and register it in the transposition table if used.
+     * @param {const state &} s; labelling state
+     * @param {const MD &} mod; model at the state
+     * @param {unsigned} depth; depth of the node
+     * @return Return the indice of the created decision node.
+     */
+    node_index add_dnode(const state &s, const MD &mod, unsigned depth) {
+        node_index v = tree.add_dnode(s,mod,depth);
+        if(use_transposition_table) {
+            tree.transpositions.insert(transposition_key(quantizer.hash(s),mod),NULL_INDEX,v);
+        }
+        return v;
+    }
+
+    /**
+     * @brief Get outcome
+     *
+     * Get the decision node labelled by a sampled state among the outcomes of a chance node.
+     * If the state was not sampled yet, it is linked to the decision node reached by
+     * another path if the transposition table is used, or to a new decision node unless
+     * the tree is full.
+     * The number of samples of the outcome is counted if double progressive widening is
+     * used.
+     * @param {node_index} c; indice of the chance node
+     * @param {const state &} s_p; sampled state
+     * @param {double} r; reward of the transition
+     * @param {const MD &} mod; model at the sampled state
+     * @return Return the indice of the outcome decision node, NULL_INDEX if the tree is full.
+     */
+    node_index get_outcome(node_index c, const state &s_p, double r, const MD &mod) {
+        node_index ind = NULL_INDEX;
+        {
+            auto lock = read_lock();
+            if(is_state_already_sampled(c,s_p,ind)) {
+                if(dpw_coefficient > 0.) {
+                    tree.count_outcome(c,ind);
+                }
+                return ind;
+            }
+        }
+        auto lock = write_lock();
+        if(locks && is_state_already_sampled(c,s_p,ind)) { // sampled meanwhile by another thread
+            if(dpw_coefficient > 0.) {
+                tree.count_outcome(c,ind);
             }
+            return ind;
         }
-        return false;
+        if(!use_transposition_table || (ind = find_transposition(s_p,mod)) == NULL_INDEX) {
+            if(is_tree_full()) {
+                return NULL_INDEX;
+            }
+            ind = add_dnode(s_p,mod,tree.cnodes[c].depth+1);
+        }
+        tree.add_outcome(c,ind,quantizer.hash(s_p),r);
+        return ind;
     }
 
     /**
      * @brief Search tree
      *
      * Search within the tree, starting from the input decision node.
-     * Recursive method.
-     * @param {dnode *} v; input decision node
-     * @return Return the sampled return at the given decision node
+     * If the transposition table is used, a sampled state already labelling a decision node
+     * elsewhere in the tree is linked to this node, turning the tree into a DAG whose
+     * decision nodes share their statistics across paths.
+     * Once the tree is full, the leaves and the new outcomes are evaluated by a rollout
+     * without being added to the tree.
+     * With double progressive widening, a chance node having as many outcomes as allowed
+     * is followed by one of its outcomes, with the reward recorded on the edge, instead of
+     * a call to the generative model.
+     * Several threads may search a shared tree concurrently: the rollouts and the
+     * selections run without locking and a virtual loss is applied to the selected chance
+     * nodes until their update.
+     * The evaluation of the new chance node may be deferred, e.g. to a rollout batch, in
+     * which case the descent stops there and the return is not backed up.
+     * Iterative method: the selected chance nodes and the rewards of the sampled
+     * transitions are recorded in the path of the workspace during the descent, then the
+     * return is backed up along the path.
+     * @param {node_index} v; indice of the input decision node
+     * @param {MD &} mod; model
+     * @param {search_workspace &} ws; buffers of the calling thread
+     * @param {deferred_leaf *} leaf; if not null, set to the new chance node, if any,
+     * whose evaluation is then deferred
+     * @return Return the sampled return at the given decision node, 0 if deferred
      */
-    double search_tree(dnode * v, MD &mod) {
-        if(mod.is_terminal(v->s)) { // terminal node
-            return terminal_state_value;
-        } else if(!v->is_fully_expanded()) { // leaf node, expand it
-            return evaluate(v, mod);
-        } else { // apply tree policy
-            cnode * ptr = select_child(v);
-            state s_p = generative_model(v->s,ptr->a,mod);
-            double r = mod.reward_function(v->s,ptr->a,s_p);
+    double search_tree(node_index v, MD &mod, search_workspace &ws, deferred_leaf *leaf = nullptr) {
+        ws.path.clear();
+        if(leaf != nullptr) {
+            leaf->c = NULL_INDEX;
+        }
+        double q = terminal_state_value;
+        state s = tree.dnodes[v].s; // sampled state, the label of the node being equivalent
+        for(;;) {
+            if(mod.is_terminal(s)) { // terminal node
+                break;
+            }
+            node_index c = expand(v,mod);
+            if(c != NULL_INDEX) { // leaf node, evaluate the new child
+                if(leaf != nullptr) {
+                    leaf->c = c;
+                    leaf->s = s;
+                    return 0.;
+                }
+                q = evaluate(c, s, mod);
+                break;
+            }
+            if(tree.dnodes[v].nb_children == 0) { // leaf node of a full tree
+                q = evaluate_state(s,mod);
+                break;
+            }
+            c = select_child(v,ws); // apply tree policy
+            if(locks) { // virtual loss, removed by 'update_value'
+                ++tree.pending[c];
+            }
+            if(is_outcome_widened(c)) { // revisit an existing outcome
+                double r;
+                {
+                    auto lock = read_lock();
+                    v = tree.sample_outcome(c,r);
+                }
+                ws.path.push_back(search_workspace::step{c,r});
+                s = tree.dnodes[v].s;
+                if(is_model_dynamic) {
+                    mod.step(s);
+                }
+                continue;
+            }
+            const std::shared_ptr<action> &a = mod.action_space[tree.cnodes[c].action];
+            state s_p = generative_model(s,a,mod);
+            double r = mod.reward_function(s,a,s_p);
+            ws.path.push_back(search_workspace::step{c,r});
             if(is_model_dynamic) {
                 mod.step(s_p);
             }
-            double q = 0.;
-            unsigned ind = 0; // indice of resulting child
-            if(is_state_already_sampled(ptr,s_p,ind)) { // go to node
-                q = r + discount_factor * search_tree(ptr->children.at(ind).get(), mod);
-            } else { // leaf node, create a new node
-                ptr->children.emplace_back(std::unique_ptr<dnode>(
-                    new dnode(s_p,mod.get_action_space(s_p),ptr->depth+1)
-                ));
-                q = r + discount_factor * evaluate(ptr->get_last_child(), mod);
-            }
-            update_value(ptr,q);
-            return q;
+            v = get_outcome(c,s_p,r,mod); // indice of resulting child
+            if(v == NULL_INDEX) { // new outcome of a full tree
+                q = mod.is_terminal(s_p) ? terminal_state_value : evaluate_state(s_p,mod);
+                break;
+            }
+            s = s_p;
         }
-        /* // Original implementation (slower)
-        if(mod.is_terminal(v->s)) { // terminal node
-            return 0.;
-        } else if(v->is_leaf()) { // leaf node, expand it
-            return evaluate(v->s);
-        } else { // apply tree policy
-            cnode<state,AC> * ptr = select_child(v);
-            state s_p = generative_model(v->s,ptr->a,mod);
-            double r = mod.reward_function(v->s,ptr->a,s_p);
-            ptr->children.emplace_back(std::unique_ptr<dnode>(
-                new dnode(s_p,mod.get_action_space(s_p),ptr->depth+1)
-            );
-            double q = r + discount_factor * search_tree(ptr->get_last_child());
-            update_value(ptr,q);
-            return q;
+        return backup(ws,q,false);
+    }
+
+    /**
+     * @brief Is search decided
+     *
+     * Stopping rule, tested every 'early_stop_period' iterations: the search is decided once
+     * every action of the root is expanded and the child of maximum value is separated from
+     * the other ones (see 'is_best_arm_separated'), the recommended action being then
+     * unlikely to change.
+     * @param {node_index} root; indice of the root node
+     * @param {unsigned} k; number of iterations run
+     * @return Return true if the search may stop.
+     */
+    bool is_search_decided(node_index root, unsigned k) const {
+        if(early_stop_period == 0 || k == 0 || k % early_stop_period != 0) {
+            return false;
+        }
+        const dnode &d = tree.dnodes[root];
+        if(!d.is_fully_expanded()) {
+            return false;
         }
-        */
+        return is_best_arm_separated(d.nb_children,early_stop_z,[&](unsigned i, unsigned &n, double &mean, double &variance) {
+            n = tree.get_nb_visits(d.first_child + i);
+            mean = tree.get_value(d.first_child + i);
+            variance = tree.get_variance(d.first_child + i);
+        });
     }
 
     /**
      * @brief Build tree
      *
      * Build a tree at the input root node.
-     * @param {dnode &} root; reference to the input root node
+     * The root may already have been expanded, e.g. by a previous search.
+     * The search ends after the given number of iterations, when the time limit expires or
+     * when the stopping rule is met, at least one iteration being run.
+     * @param {node_index} root; indice of the root node
+     * @param {unsigned} nb_iterations; maximum number of iterations
+     * @return Return the number of iterations run.
      */
-    void build_tree(dnode &root) {
-        for(unsigned i=0; i<budget; ++i) {
-            MD mod = model.get_copy();
-            search_tree(&root, mod);
+    unsigned build_tree(node_index root, unsigned nb_iterations) {
+        nb_cnodes = tree.get_nb_cnodes();
+        if(locks) { // the threads of the pool share the iterations
+            if(max_nb_records == 0) { // no reallocation during the search
+                tree.reserve(nb_iterations + 1,model.action_space.size());
+            } else { // bounded by the maximum number of records, whatever the number of iterations
+                tree.reserve_records(max_nb_records + model.action_space.size() + 1);
+            }
+            atomic_value<unsigned> nb_started(0);
+            atomic_value<unsigned> nb_run(0);
+            pool->seeded_parallel_for(nb_threads,[&](unsigned i) {
+                for(unsigned k = nb_started++; k < nb_iterations; k = nb_started++) {
+                    if(k > 0 && time_limit.is_expired()) {
+                        break;
+                    }
+                    if(is_search_decided(root,k)) {
+                        nb_started = nb_iterations; // the other threads stop at their next iteration
+                        break;
+                    }
+                    if(is_model_dynamic) { // the iteration updates its own copy of the model
+                        MD mod = model.get_copy();
+                        search_tree(root, mod, workspaces[i]);
+                    } else { // the model is only read
+                        search_tree(root, model, workspaces[i]);
+                    }
+                    ++nb_run;
+                }
+            });
+            nb_iterations_spent += nb_run;
+            return nb_run;
+        } else if(rollout_batch_size > 1) {
+            return build_tree_batched(root,nb_iterations);
+        } else {
+            unsigned i = 0;
+            for(; i<nb_iterations; ++i) {
+                if(i > 0 && time_limit.is_expired()) {
+                    break;
+                }
+                if(is_search_decided(root,i)) {
+                    break;
+                }
+                if(is_model_dynamic) {
+                    MD mod = model.get_copy();
+                    search_tree(root, mod, workspaces[0]);
+                } else {
+                    search_tree(root, model, workspaces[0]);
+                }
+            }
+            nb_iterations_spent += i;
+            return i;
         }
-        nb_cnodes = 0;
+    }
+
+    /**
+     * @brief Build tree batched
+     *
+     * Sequential 'build_tree' whose leaf rollouts are simulated in lockstep (see
+     * 'rollout_batch'): the descents are run until 'rollout_batch_size' of them end at a new
+     * chance node, whose evaluation is deferred, a virtual loss being applied along their
+     * paths so that the next descents spread over other branches; the rollouts of the
+     * deferred leaves are then run in a batch, as in 'sample_return', and their returns are
+     * backed up.
+     * @param {node_index} root; indice of the root node
+     * @param {unsigned} nb_iterations; maximum number of iterations
+     * @return Return the number of iterations run.
+     */
+    unsigned build_tree_batched(node_index root, unsigned nb_iterations) {
+        deferred_leaves.resize(rollout_batch_size);
+        deferred_models.reserve(rollout_batch_size * nb_leaf_rollouts);
+        unsigned i = 0;
+        bool is_stopped = false;
+        while(!is_stopped) {
+            unsigned nb_deferred = 0;
+            deferred_models.clear();
+            while(nb_deferred < rollout_batch_size) {
+                if(i >= nb_iterations || (i > 0 && time_limit.is_expired()) || is_search_decided(root,i)) {
+                    is_stopped = true;
+                    break;
+                }
+                ++i;
+                deferred_leaf &leaf = deferred_leaves[nb_deferred];
+                MD *mod = &model;
+                if(is_model_dynamic) { // the descent updates its own copy of the model
+                    deferred_models.emplace_back(model);
+                    mod = &deferred_models.back();
+                }
+                search_tree(root,*mod,leaf.ws,&leaf);
+                if(leaf.c == NULL_INDEX) { // backed up by the descent
+                    if(is_model_dynamic) {
+                        deferred_models.pop_back();
+                    }
+                    continue;
+                }
+                double q = terminal_state_value;
+                bool is_evaluated = mod->is_terminal(leaf.s);
+                if(!is_evaluated && rollout_memo) { // signature before the rollout updates the model
+                    leaf.signature = mod->get_signature();
+                    is_evaluated = rollout_memo->find(leaf.s,tree.cnodes[leaf.c].action,leaf.signature,q);
+                }
+                if(!is_evaluated) { // deferred, with a virtual loss along the path
+                    for(unsigned k=1; k<nb_leaf_rollouts && is_model_dynamic; ++k) {
+                        deferred_models.emplace_back(*mod);
+                    }
+                    ++tree.pending[leaf.c];
+                    for(auto &st : leaf.ws.path) {
+                        ++tree.pending[st.c];
+                    }
+                    ++nb_deferred;
+                    continue;
+                }
+                if(is_model_dynamic) {
+                    deferred_models.pop_back();
+                }
+                update_value(leaf.c,q);
+                backup(leaf.ws,q,false);
+            }
+            if(nb_deferred == 0) {
+                continue;
+            }
+            batch_requests.clear();
+            for(unsigned k=0; k<nb_deferred; ++k) {
+                const deferred_leaf &leaf = deferred_leaves[k];
+                for(unsigned j=0; j<nb_leaf_rollouts; ++j) {
+                    MD *mod = is_model_dynamic ? &deferred_models[k * nb_leaf_rollouts + j] : &model;
+                    batch_requests.push_back(rollout_request<MD>{leaf.s,&model.action_space[tree.cnodes[leaf.c].action],mod});
+                }
+            }
+            unsigned nb_steps = 0;
+            batch.run(rollouts,model,batch_requests,default_policy,nb_steps);
+            nb_calls += nb_steps;
+            for(unsigned k=0; k<nb_deferred; ++k) {
+                deferred_leaf &leaf = deferred_leaves[k];
+                double q = 0.;
+                for(unsigned j=0; j<nb_leaf_rollouts; ++j) {
+                    q += batch_requests[k * nb_leaf_rollouts + j].value;
+                }
+                q /= (double) nb_leaf_rollouts;
+                if(rollout_memo) {
+                    rollout_memo->insert(leaf.s,tree.cnodes[leaf.c].action,leaf.signature,q);
+                }
+                update_value(leaf.c,q);
+                --tree.pending[leaf.c];
+                backup(leaf.ws,q,true);
+            }
+        }
+        nb_iterations_spent += i;
+        return i;
+    }
+
+    /**
+     * @brief Backup
+     *
+     * Back up a return sampled at the end of a descent along its path.
+     * @param {const search_workspace &} ws; buffers of the descent, holding its path
+     * @param {double} q; sampled return
+     * @param {bool} is_deferred; remove the virtual loss applied to a deferred leaf
+     * @return Return the return at the start of the path.
+     */
+    double backup(const search_workspace &ws, double q, bool is_deferred) {
+        for(auto it = ws.path.rbegin(); it != ws.path.rend(); ++it) {
+            q = it->reward + discount_factor * q;
+            update_value(it->c,q);
+            if(is_deferred) {
+                --tree.pending[it->c];
+            }
+        }
+        return q;
+    }
+
+    /**
+     * @brief Sequential halving
+     *
+     * Build a tree at the input root node for a simple-regret decision at the root: the
+     * children of the root are created first, then the remaining iterations are split into
+     * ceil(log2(number of children)) rounds, each one spread evenly over the remaining
+     * children (see 'halving_strategy') before the lower half of them, by value, is
+     * dropped; UCT is applied below the root.
+     * With a time limit, each round also gets an even share of the remaining time (see
+     * 'deadline::share'), so that a round cut by its share is still followed by the halving
+     * of its children rather than taking the whole time budget.
+     * The halving stops early with the search, i.e. when the time limit expires or when the
+     * stopping rule is met, the remaining children being those of the last round.
+     * @param {node_index} root; indice of the root node
+     * @param {unsigned} nb_iterations; maximum number of iterations
+     */
+    void sequential_halving(node_index root, unsigned nb_iterations) {
+        halving_root = root;
+        halving_arms.clear();
+        unsigned nb_run = 0;
+        bool is_stopped = false;
+        while(!is_widened(root) && nb_run < nb_iterations) { // an iteration creates a child
+            unsigned nb_children = tree.dnodes[root].nb_children;
+            unsigned n = std::min<unsigned>(nb_iterations - nb_run,tree.dnodes[root].nb_actions - nb_children);
+            unsigned k = build_tree(root,n);
+            nb_run += k;
+            if(k < n || time_limit.is_expired() || tree.dnodes[root].nb_children == nb_children) { // stopped, or terminal root or full tree
+                is_stopped = true;
+                break;
+            }
+        }
+        const dnode &d = tree.dnodes[root];
+        for(node_index c = d.first_child; c < d.first_child + d.nb_children; ++c) {
+            halving_arms.push_back(c);
+        }
+        for(unsigned nb_rounds = nb_halving_rounds(halving_arms.size()); !is_stopped && nb_rounds > 0; --nb_rounds) {
+            unsigned n = (nb_iterations - nb_run) / nb_rounds;
+            deadline::clock::time_point decision_end = time_limit.share(nb_rounds);
+            unsigned k = build_tree(root,n);
+            bool is_round_expired = time_limit.is_expired();
+            time_limit.end = decision_end;
+            nb_run += k;
+            if(k < n && !is_round_expired) { // stopping rule met within the round
+                break;
+            }
+            halve_arms(halving_arms,[&](node_index c) {return tree.get_value(c);});
+            is_stopped = time_limit.is_expired();
+        }
+        halving_root = NULL_INDEX;
     }
 
     /**
      * @brief Argmax value
      *
      * Get the indice of the child with the maximum value.
-     * @param {const dnode &} v; input decision node
+     * @param {node_index} v; indice of the input decision node
      * @return Return the indice of the child with the maximum value.
      */
-    unsigned argmax_value(const dnode &v) const {
+    node_index argmax_value(node_index v) const {
+        const dnode &d = tree.dnodes[v];
+        std::vector<double> values;
+        for(node_index c = d.first_child; c < d.first_child + d.nb_children; ++c) {
+            values.emplace_back(tree.get_value(c));
+        }
+        return d.first_child + argmax(values);
+    }
+
+    /**
+     * @brief Is recommendable
+     *
+     * Test whether a root chance node may be recommended, i.e. remains in the last
+     * sequential halving if any.
+     * @param {node_index} c; indice of the chance node
+     * @return Return true if the chance node may be recommended.
+     */
+    bool is_recommendable(node_index c) const {
+        return halving_arms.empty() || std::find(halving_arms.begin(),halving_arms.end(),c) != halving_arms.end();
+    }
+
+    /**
+     * @brief Recommended child
+     *
+     * Get the indice of the recommendable child of the root with the maximum value.
+     * @param {node_index} root; indice of the root node
+     * @return Return the indice of the recommended child.
+     */
+    node_index recommended_child(node_index root) const {
+        if(halving_arms.empty()) {
+            return argmax_value(root);
+        }
+        return halving_arms[argmax_of(halving_arms.size(),[&](unsigned i) {
+            return tree.get_value(halving_arms[i]);
+        })];
+    }
+
+    /**
+     * @brief Promote subtree
+     *
+     * Look for the given state among the outcomes of the chance node of the last
+     * recommended action.
+     * If found, the subtree of this outcome becomes the tree, rooted at the outcome.
+     * @param {const state &} s; current state of the agent
+     * @return Return the indice of the promoted root, NULL_INDEX if the state was not sampled.
+     */
+    node_index promote_subtree(const state &s) {
+        node_index v = NULL_INDEX;
+        if(root_choice != NULL_INDEX && is_state_already_sampled(root_choice,s,v)) {
+            v = tree.extract_subtree(v,spare_tree);
+            std::swap(tree,spare_tree);
+            tree.dnodes[v].s = s; // the outcome may be an abstract state
+        }
+        root_choice = NULL_INDEX;
+        return v;
+    }
+
+    /**
+     * @brief Plan
+     *
+     * Build the tree at the given state, the model being updated afterwards by
+     * 'update_model'.
+     * If the tree is reused and the state matches a sampled outcome of the previous
+     * recommended action, the search starts from the corresponding subtree and its visits
+     * are deducted from the budget; otherwise the tree is cleared, its pools being reused.
+     * The tree is built by 'sequential_halving' if mcts_strategy_switch is 2.
+     * @param {const state &} s; current state of the agent
+     * @return Return the indice of the root node.
+     */
+    node_index plan(const state &s) {
+        stop_pondering();
+        time_limit.start();
+        node_index root = reuse_tree ? promote_subtree(s) : NULL_INDEX;
+        unsigned nb_reused = 0;
+        if(root == NULL_INDEX) {
+            tree.clear();
+            root = add_dnode(s,model,0);
+        } else {
+            nb_reused = std::min(budget,tree.get_dnode_nb_visits(root));
+        }
+        if(mcts_strategy_switch == 2) {
+            sequential_halving(root,budget - nb_reused);
+        } else {
+            build_tree(root,budget - nb_reused);
+        }
+        ++nb_decisions;
+        nb_reused_visits += nb_reused;
+        return root;
+    }
+
+    /**
+     * @brief Root-parallel plan
+     *
+     * Each worker builds its own tree at the given state with its own model copy and
+     * random stream, then the statistics of the recommendable root chance nodes are merged
+     * by action.
+     * @param {const state &} s; current state of the agent
+     * @return Return the action with the maximum merged value.
+     */
+    std::shared_ptr<action> root_parallel_plan(const state &s) {
+        std::vector<node_index> roots(workers.size());
+        pool->seeded_parallel_for(workers.size(),[&](unsigned i) {
+            roots[i] = workers[i].plan(s);
+        });
+        ++nb_decisions;
+        std::vector<running_statistics> merged(model.action_space.size());
+        for(unsigned i=0; i<workers.size(); ++i) {
+            const mcts_tree &t = workers[i].tree;
+            const dnode &d = t.dnodes[roots[i]];
+            for(node_index c = d.first_child; c < d.first_child + d.nb_children; ++c) {
+                if(workers[i].is_recommendable(c)) {
+                    merged[t.cnodes[c].action].merge(t.visits[c],t.means[c],t.m2s[c]);
+                }
+            }
+        }
+        std::vector<unsigned> expanded;
         std::vector<double> values;
-        for(auto &c: v.children) {
-            values.emplace_back(c->get_value());
+        for(unsigned k=0; k<merged.size(); ++k) {
+            if(merged[k].get_count() > 0) {
+                expanded.push_back(k);
+                values.push_back(merged[k].get_mean());
+            }
+        }
+        unsigned best = expanded[argmax(values)];
+        for(unsigned i=0; i<workers.size(); ++i) { // the subtree of the chosen action may be reused
+            const mcts_tree &t = workers[i].tree;
+            const dnode &d = t.dnodes[roots[i]];
+            workers[i].root_choice = NULL_INDEX;
+            for(node_index c = d.first_child; c < d.first_child + d.nb_children; ++c) {
+                if(t.cnodes[c].action == best) {
+                    workers[i].root_choice = c;
+                }
+            }
         }
-        return argmax(values);
+        return model.action_space[best];
     }
 
     /**
-     * @brief Argmax visit counter
+     * @brief Stop search
      *
-     * Get the indice of the child with the maximum number of visits.
-     * @param {const dnode &} v; input decision node
-     * @return Return the indice of the child with the maximum number of visits.
+     * Request the end of the current search, which then returns its current best action.
+     * May be called from any thread.
      */
-    unsigned argmax_nb_visits(const dnode &v) const {
-        std::vector<unsigned> nb_visits;
-        for(auto &c: v.children) {
-            nb_visits.emplace_back(c->get_nb_visits());
+    void stop_search() {
+        time_limit.stop();
+        for(auto &w : workers) {
+            w.stop_search();
         }
-        return argmax(nb_visits);
     }
 
     /**
-     * @brief Recommended action
+     * @brief Clear stop
      *
-     * Get the recommended action from an input decision node.
-     * @param {const dnode &} v; input decision node
-     * @return Return the recommended action at the input decision node.
+     * Clear the request of 'stop_search', before a new search.
      */
-    std::shared_ptr<action> recommended_action(const dnode &v) {
-        //return v.children.at(argmax_nb_visits(v))->a; // higher number of visits
-        return v.children.at(argmax_value(v))->a; // higher value
+    void clear_stop() {
+        time_limit.clear_stop();
+        for(auto &w : workers) {
+            w.clear_stop();
+        }
+    }
+
+    /**
+     * @brief Search
+     *
+     * Search at the given state and recommend an action, without updating the model; the
+     * search may thus be speculative, i.e. run at a predicted state, then either confirmed
+     * by 'update_model' or dropped by 'discard_search'.
+     * @param {const state &} s; state of the agent
+     * @return Return the recommended action at s.
+     */
+    std::shared_ptr<action> search(const state &s) {
+        if(!workers.empty()) {
+            return root_parallel_plan(s);
+        }
+        node_index root = plan(s);
+        root_choice = recommended_child(root);
+        return model.action_space[tree.cnodes[root_choice].action];
+    }
+
+    /**
+     * @brief Update model
+     *
+     * Go to the next state of the model, and of the models of the workers, once the action
+     * recommended at the given state is undertaken; the pondering then starts.
+     * @param {const state &} s; current state of the agent
+     */
+    void update_model(const state &s) {
+        model.step(s);
+        for(auto &w : workers) {
+            w.update_model(s);
+        }
+        start_pondering(s);
+    }
+
+    /**
+     * @brief Ponder iteration
+     *
+     * Search iteration below the chance node of the recommended action: an outcome is
+     * sampled, or revisited with double progressive widening, and searched.
+     * @param {const state &} s; state at which the action was recommended
+     * @param {MD &} mod; model
+     * @return Return false if the tree is full, no outcome being added.
+     */
+    bool ponder_iteration(const state &s, MD &mod) {
+        node_index c = root_choice;
+        node_index v;
+        if(is_outcome_widened(c)) {
+            double r;
+            v = tree.sample_outcome(c,r);
+            if(is_model_dynamic) {
+                mod.step(tree.dnodes[v].s);
+            }
+        } else {
+            const std::shared_ptr<action> &a = mod.action_space[tree.cnodes[c].action];
+            state s_p = generative_model(s,a,mod);
+            double r = mod.reward_function(s,a,s_p);
+            if(is_model_dynamic) {
+                mod.step(s_p);
+            }
+            v = get_outcome(c,s_p,r,mod);
+        }
+        if(v == NULL_INDEX) {
+            return false;
+        }
+        search_tree(v,mod,workspaces[0]);
+        return true;
+    }
+
+    /**
+     * @brief Start pondering
+     *
+     * Extend the subtrees of the outcomes of the recommended action on a background thread
+     * until the next decision, which then starts from the subtree of the reached state.
+     * The pondering stops after 'budget' iterations, the next decision reusing at most this
+     * number of visits.
+     * @param {const state &} s; state at which the action was recommended
+     */
+    void start_pondering(const state &s) {
+        if(!ponder_pool || root_choice == NULL_INDEX) {
+            return;
+        }
+        is_pondering = true;
+        nb_cnodes = tree.get_nb_cnodes(); // UCT exploration factor of the descents
+        ponder_pool->submit([this,s,mod = model.get_copy()]() mutable {
+            for(unsigned k=0; k<budget && is_pondering; ++k) {
+                bool is_extended;
+                if(is_model_dynamic) { // the iteration updates its own copy of the model
+                    MD iteration_model(mod);
+                    is_extended = ponder_iteration(s,iteration_model);
+                } else {
+                    is_extended = ponder_iteration(s,mod);
+                }
+                if(!is_extended) {
+                    break;
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Stop pondering
+     *
+     * Stop the pondering and wait for its end, after which the tree may be used again.
+     */
+    void stop_pondering() {
+        if(ponder_pool) {
+            is_pondering = false;
+            ponder_pool->wait();
+        }
+    }
+
+    /**
+     * @brief Discard search
+     *
+     * Drop the last search, whose state was not reached: its subtrees are not reused.
+     */
+    void discard_search() {
+        stop_pondering();
+        root_choice = NULL_INDEX;
+        for(auto &w : workers) {
+            w.discard_search();
+        }
     }
 
     /**
@@ -352,10 +1472,9 @@ public:
      * @return Return the undertaken action at s.
      */
     std::shared_ptr<action> operator()(const state &s) {
-        dnode root(s,model.get_action_space(s));
-        build_tree(root);
-        model.step(s); // update the model
-        return recommended_action(root);
+        std::shared_ptr<action> a = search(s);
+        update_model(s);
+        return a;
     }
 
     /**
@@ -380,11 +1499,33 @@ public:
     /**
      * @brief Get backup
      *
-     * Get the backed-up values.
+     * Get the backed-up values, aggregated over the workers in root-parallel mode.
+     * The pondering is stopped first.
      * @return Return a vector containing the values to be saved.
      */
-    std::vector<double> get_backup() const {
-        return std::vector<double>{(double)nb_calls};
+    std::vector<double> get_backup() {
+        stop_pondering();
+        for(auto &w : workers) {
+            w.stop_pondering();
+        }
+        double calls = nb_calls;
+        double reused = nb_reused_visits;
+        double iterations = nb_iterations_spent;
+        double lookups = rollout_memo ? rollout_memo->nb_lookups : 0.;
+        double hits = rollout_memo ? rollout_memo->nb_hits : 0.;
+        for(auto &w : workers) {
+            calls += w.nb_calls;
+            reused += w.nb_reused_visits;
+            iterations += w.nb_iterations_spent;
+            if(w.rollout_memo) {
+                lookups += w.rollout_memo->nb_lookups;
+                hits += w.rollout_memo->nb_hits;
+            }
+        }
+        double reused_budget = (nb_decisions == 0) ? 0. : reused / ((double) nb_decisions * budget);
+        double rollout_hit_rate = (lookups == 0.) ? 0. : hits / lookups;
+        double iterations_per_decision = (nb_decisions == 0) ? 0. : iterations / ((double) nb_decisions);
+        return std::vector<double>{calls,reused_budget,rollout_hit_rate,iterations_per_decision};
     }
 };
 
@@ -0,0 +1,178 @@
+#ifndef ROLLOUT_CACHE_HPP_
+#define ROLLOUT_CACHE_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <mcts/state_hash.hpp>
+
+/**
+ * @brief Rollout cache
+ *
+ * Memo of the returns of deterministic rollouts, i.e. with a noise-free model and a
+ * deterministic default policy, keyed by the exact starting state (time included), the
+ * first action and the signature of the model.
+ * The cache holds at most 'capacity' returns, the least recently used one being evicted
+ * when full.
+ * The accesses are serialized by a lock so that the threads of a shared tree search may
+ * use the same cache.
+ */
+class rollout_cache {
+public:
+    /**
+     * @brief Entry of the cache
+     */
+    class entry {
+    public:
+        state s; ///< Starting state of the rollout
+        unsigned action; ///< Indice of the first action
+        std::uint64_t signature; ///< Signature of the model
+        std::uint64_t key; ///< Hash of the three above
+        double value; ///< Return of the rollout
+        unsigned prev; ///< Previous entry in the recency list, more recently used
+        unsigned next; ///< Next entry in the recency list, less recently used
+    };
+
+    static constexpr unsigned NONE = static_cast<unsigned>(-1); ///< Null entry indice
+
+    unsigned capacity; ///< Maximum number of entries
+    std::vector<entry> entries; ///< Entries, allocated up to the capacity
+    std::unordered_map<std::uint64_t,unsigned> index; ///< Entry indice of each key
+    unsigned head; ///< Most recently used entry
+    unsigned tail; ///< Least recently used entry
+    unsigned long long nb_lookups; ///< Number of lookups
+    unsigned long long nb_hits; ///< Number of successful lookups
+    std::mutex lock; ///< Lock of the cache
+
+    /**
+     * @brief Constructor
+     *
+     * @param {unsigned} _capacity; maximum number of entries
+     */
+    rollout_cache(unsigned _capacity) :
+        capacity(_capacity), head(NONE), tail(NONE), nb_lookups(0), nb_hits(0)
+    {
+        index.reserve(capacity);
+    }
+
+    /**
+     * @brief Hash key
+     *
+     * Hash the exact value of the starting state, the first action and the signature.
+     * @param {const state &} s; starting state
+     * @param {unsigned} action; indice of the first action
+     * @param {std::uint64_t} signature; signature of the model
+     * @return Return the hash value.
+     */
+    static std::uint64_t hash_key(const state &s, unsigned action, std::uint64_t signature) {
+        std::uint64_t h = hash_combine(signature,action);
+        h = hash_combine(h,s.t);
+        h = hash_combine(h,s.waypoints_reached_counter);
+        for(double c : {s.x,s.y,s.v,s.theta}) {
+            std::uint64_t bits;
+            std::memcpy(&bits,&c,sizeof(bits));
+            h = hash_combine(h,bits);
+        }
+        return h;
+    }
+
+    /**
+     * @brief Unlink
+     *
+     * Remove an entry from the recency list.
+     * @param {unsigned} i; entry indice
+     */
+    void unlink(unsigned i) {
+        entry &e = entries[i];
+        (e.prev == NONE ? head : entries[e.prev].next) = e.next;
+        (e.next == NONE ? tail : entries[e.next].prev) = e.prev;
+    }
+
+    /**
+     * @brief Push front
+     *
+     * Insert an entry at the front of the recency list.
+     * @param {unsigned} i; entry indice
+     */
+    void push_front(unsigned i) {
+        entries[i].prev = NONE;
+        entries[i].next = head;
+        (head == NONE ? tail : entries[head].prev) = i;
+        head = i;
+    }
+
+    /**
+     * @brief Find
+     *
+     * Look for the return of a rollout, the found entry becomes the most recently used.
+     * @param {const state &} s; starting state
+     * @param {unsigned} action; indice of the first action
+     * @param {std::uint64_t} signature; signature of the model
+     * @param {double &} value; return of the rollout, set if found
+     * @return Return true if the return was found.
+     */
+    bool find(const state &s, unsigned action, std::uint64_t signature, double &value) {
+        std::uint64_t key = hash_key(s,action,signature);
+        std::lock_guard<std::mutex> guard(lock);
+        ++nb_lookups;
+        auto it = index.find(key);
+        if(it == index.end()) {
+            return false;
+        }
+        entry &e = entries[it->second];
+        if(!(e.action == action && e.signature == signature && e.s.t == s.t
+        && e.s.waypoints_reached_counter == s.waypoints_reached_counter
+        && e.s.x == s.x && e.s.y == s.y && e.s.v == s.v && e.s.theta == s.theta)) { // hash collision
+            return false;
+        }
+        ++nb_hits;
+        unlink(it->second);
+        push_front(it->second);
+        value = e.value;
+        return true;
+    }
+
+    /**
+     * @brief Insert
+     *
+     * Record the return of a rollout, evicting the least recently used entry if full.
+     * An entry colliding with the key is replaced.
+     * @param {const state &} s; starting state
+     * @param {unsigned} action; indice of the first action
+     * @param {std::uint64_t} signature; signature of the model
+     * @param {double} value; return of the rollout
+     */
+    void insert(const state &s, unsigned action, std::uint64_t signature, double value) {
+        std::uint64_t key = hash_key(s,action,signature);
+        std::lock_guard<std::mutex> guard(lock);
+        if(capacity == 0) {
+            return;
+        }
+        unsigned i;
+        auto it = index.find(key);
+        if(it != index.end()) { // same key, e.g. inserted meanwhile by another thread
+            i = it->second;
+            unlink(i);
+        } else if(entries.size() < capacity) {
+            i = entries.size();
+            entries.emplace_back();
+            index.emplace(key,i);
+        } else { // evict the least recently used entry
+            i = tail;
+            unlink(i);
+            index.erase(entries[i].key);
+            index.emplace(key,i);
+        }
+        entries[i].s = s;
+        entries[i].action = action;
+        entries[i].signature = signature;
+        entries[i].key = key;
+        entries[i].value = value;
+        push_front(i);
+    }
+};
+
+#endif // ROLLOUT_CACHE_HPP_
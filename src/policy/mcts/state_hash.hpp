@@ -0,0 +1,195 @@
+#ifndef STATE_HASH_HPP_
+#define STATE_HASH_HPP_
+
+#include <cmath>
+#include <cstdint>
+
+#include <utils.hpp>
+
+constexpr double STATE_HASH_STEP = 1e-6; ///< Default quantization step of the state hash
+
+/**
+ * @brief Hash combine
+ *
+ * Combine a hash value with a new value.
+ * @param {std::uint64_t} seed; current hash value
+ * @param {std::uint64_t} v; combined value
+ * @return Return the resulting hash value.
+ */
+inline std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t v) {
+    return hash_mix(seed ^ (v + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+/**
+ * @brief State quantizer
+ *
+ * Hash the states on a grid of the continuous coordinates (x, y, v, theta); the discrete
+ * attributes (time and waypoints counter) are hashed exactly.
+ * Two states equal up to a tolerance smaller than the quantization step either have the
+ * same cell or lie on both sides of a cell boundary; 'for_each_candidate_hash' therefore
+ * enumerates the neighbouring cells within tolerance, which is a single cell in most cases.
+ * A coordinate may also be abstracted: two states are then equivalent along it if they lie
+ * in the same cell, whatever their distance (see 'is_equivalent').
+ */
+class state_quantizer {
+public:
+    double steps[4]; ///< Quantization steps of x, y, v and theta
+    bool is_abstracted[4]; ///< Coordinates compared by cell instead of up to a tolerance
+
+    /**
+     * @brief Constructor
+     *
+     * @param {double} step; quantization step of every continuous coordinate
+     */
+    state_quantizer(double step = STATE_HASH_STEP) :
+        steps{step,step,step,step},
+        is_abstracted{false,false,false,false}
+    {}
+
+    /**
+     * @brief Set abstraction
+     *
+     * Abstract a coordinate with the given cell size, a null size leaving it unchanged.
+     * @param {unsigned} d; coordinate i.e. 0 for x, 1 for y, 2 for v and 3 for theta
+     * @param {double} step; cell size
+     */
+    void set_abstraction(unsigned d, double step) {
+        if(step > 0.) {
+            steps[d] = step;
+            is_abstracted[d] = true;
+        }
+    }
+
+    /**
+     * @brief Cell
+     *
+     * @param {double} c; coordinate value
+     * @param {unsigned} d; coordinate
+     * @return Return the integer coordinate of the cell containing the value.
+     */
+    std::int64_t cell(double c, unsigned d) const {
+        return (std::int64_t) std::floor(c / steps[d]);
+    }
+
+    /**
+     * @brief Is equivalent
+     *
+     * Test whether two states are equivalent: same discrete attributes, same cell along the
+     * abstracted coordinates and equal values up to the comparison threshold along the
+     * other ones.
+     * Without abstraction, this is 'state::is_equal_to'.
+     * @param {const state &} a; first state
+     * @param {const state &} b; second state
+     * @return Return true if the states are equivalent.
+     */
+    bool is_equivalent(const state &a, const state &b) const {
+        if(a.t != b.t || a.waypoints_reached_counter != b.waypoints_reached_counter) {
+            return false;
+        }
+        double ca[4], cb[4];
+        coordinates(a,ca);
+        coordinates(b,cb);
+        for(unsigned d=0; d<4; ++d) {
+            if(is_abstracted[d] ? cell(ca[d],d) != cell(cb[d],d) : !are_equal(ca[d],cb[d])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Coordinates
+     *
+     * Copy the continuous coordinates of a state in an array.
+     * @param {const state &} s; input state
+     * @param {double *} c; output array of size 4
+     */
+    static void coordinates(const state &s, double *c) {
+        c[0] = s.x;
+        c[1] = s.y;
+        c[2] = s.v;
+        c[3] = s.theta;
+    }
+
+    /**
+     * @brief Hash cells
+     *
+     * Hash a cell given its integer coordinates and the discrete attributes of a state.
+     * @param {const state &} s; state providing the discrete attributes
+     * @param {const std::int64_t *} cells; integer coordinates of the cell, array of size 4
+     * @return Return the hash value.
+     */
+    static std::uint64_t hash_cells(const state &s, const std::int64_t *cells) {
+        std::uint64_t h = hash_combine(s.t,s.waypoints_reached_counter);
+        for(unsigned d=0; d<4; ++d) {
+            h = hash_combine(h,(std::uint64_t) cells[d]);
+        }
+        return h;
+    }
+
+    /**
+     * @brief Hash
+     *
+     * Hash of the cell containing the given state.
+     * @param {const state &} s; input state
+     * @return Return the hash value.
+     */
+    std::uint64_t hash(const state &s) const {
+        double c[4];
+        coordinates(s,c);
+        std::int64_t cells[4];
+        for(unsigned d=0; d<4; ++d) {
+            cells[d] = cell(c[d],d);
+        }
+        return hash_cells(s,cells);
+    }
+
+    /**
+     * @brief For each candidate hash
+     *
+     * Call the input function with the hash of the cell of the given state, then with the
+     * hash of every neighbouring cell containing a point equal to the state up to the
+     * given tolerance along the coordinates that are not abstracted, until the function
+     * returns true.
+     * @param {const state &} s; input state
+     * @param {double} tolerance; comparison tolerance, smaller than the steps
+     * @param {F} f; function taking a hash value, returns true to stop the enumeration
+     * @return Return true if the enumeration was stopped by the function.
+     */
+    template <class F>
+    bool for_each_candidate_hash(const state &s, double tolerance, F f) const {
+        double c[4];
+        coordinates(s,c);
+        std::int64_t cells[4];
+        std::int64_t neighbours[4]; // neighbouring cell along each dimension, if within tolerance
+        unsigned mask = 0; // dimensions having a neighbour within tolerance
+        for(unsigned d=0; d<4; ++d) {
+            double u = c[d] / steps[d];
+            cells[d] = (std::int64_t) std::floor(u);
+            double below = (u - (double) cells[d]) * steps[d];
+            if(is_abstracted[d]) { // the cell is the equivalence class
+                continue;
+            } else if(below < tolerance) {
+                neighbours[d] = cells[d] - 1;
+                mask |= 1u << d;
+            } else if(steps[d] - below < tolerance) {
+                neighbours[d] = cells[d] + 1;
+                mask |= 1u << d;
+            }
+        }
+        for(unsigned sub = 0; ; sub = (sub - mask) & mask) { // every subset of the mask, own cell first
+            std::int64_t probe[4];
+            for(unsigned d=0; d<4; ++d) {
+                probe[d] = ((sub >> d) & 1u) ? neighbours[d] : cells[d];
+            }
+            if(f(hash_cells(s,probe))) {
+                return true;
+            }
+            if(sub == mask) {
+                return false;
+            }
+        }
+    }
+};
+
+#endif // STATE_HASH_HPP_
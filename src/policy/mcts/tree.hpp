@@ -0,0 +1,455 @@
+#ifndef MCTS_TREE_HPP_
+#define MCTS_TREE_HPP_
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <atomic_value.hpp>
+#include <running_statistics.hpp>
+#include <utils.hpp>
+
+typedef std::uint32_t node_index; ///< Indice of a node in a pool of a 'mcts_tree'
+constexpr node_index NULL_INDEX = std::numeric_limits<node_index>::max(); ///< No node
+
+#include <mcts/cnode.hpp>
+#include <mcts/dnode.hpp>
+#include <mcts/state_hash.hpp>
+#include <mcts/index_table.hpp>
+
+/**
+ * @brief Outcome edge
+ *
+ * Link from a chance node to one of its sampled outcomes (a decision node).
+ * The outcome edges of a chance node form a singly linked list in the edge pool.
+ * The edge keeps the reward of the transition and the number of times the outcome was
+ * sampled, so that an outcome can be revisited without calling the generative model.
+ */
+class outcome_edge {
+public:
+    node_index child; ///< Indice of the outcome decision node
+    node_index next; ///< Indice of the next outcome edge of the same chance node
+    double reward; ///< Reward of the transition to the outcome
+    atomic_value<unsigned> nb_samples; ///< Number of times the outcome was sampled
+
+    /**
+     * @brief Constructor
+     */
+    outcome_edge(
+        node_index _child = NULL_INDEX,
+        node_index _next = NULL_INDEX,
+        double _reward = 0.,
+        unsigned _nb_samples = 1) :
+        child(_child),
+        next(_next),
+        reward(_reward),
+        nb_samples(_nb_samples)
+    {}
+};
+
+/**
+ * @brief MCTS tree
+ *
+ * Storage of a MCTS tree in contiguous pools addressed with 32 bits indices.
+ * Decision nodes, chance nodes, outcome edges and the actions of the decision nodes are
+ * each stored in a single vector; the hot statistics of the chance nodes are stored as a
+ * structure-of-arrays of running count, mean and M2 (Welford), hence the memory of a node
+ * is constant and reading its value is O(1).
+ * Every stored record is trivially destructible and the capacity of the pools is kept
+ * between two searches, hence clearing the tree is O(1) and a search does not allocate
+ * once the pools have grown to their working size.
+ * The statistics are atomic values so that the tree can be searched by several threads;
+ * the structural modifications must then be serialized by the caller and the pools must
+ * be reserved beforehand (see 'reserve') so that they are never reallocated during the
+ * search.
+ */
+class mcts_tree {
+public:
+    std::vector<dnode> dnodes; ///< Decision nodes pool
+    std::vector<cnode> cnodes; ///< Chance nodes pool
+    std::vector<outcome_edge> outcomes; ///< Outcome edges pool
+    std::vector<unsigned> actions; ///< Actions of the decision nodes (indices in the action space)
+    std::vector<atomic_value<unsigned>> visits; ///< Number of visits of each chance node
+    std::vector<atomic_value<double>> means; ///< Mean of the sampled returns of each chance node
+    std::vector<atomic_value<double>> m2s; ///< Sum of the squared deviations of the sampled returns of each chance node
+    std::vector<atomic_value<unsigned>> pending; ///< Number of descents in progress through each chance node (virtual losses)
+    index_table outcome_index; ///< Outcomes of the chance nodes, indexed by (state hash, chance node)
+    index_table transpositions; ///< Decision nodes of the whole tree, indexed by (state and model hash)
+    bool is_expansion_ordered = false; ///< Children are created in the order of the action slices instead of randomly
+
+    /**
+     * @brief Clear
+     *
+     * Remove every node of the tree, keeping the capacity of the pools.
+     */
+    void clear() {
+        dnodes.clear();
+        cnodes.clear();
+        outcomes.clear();
+        actions.clear();
+        visits.clear();
+        means.clear();
+        m2s.clear();
+        pending.clear();
+        outcome_index.clear();
+        transpositions.clear();
+    }
+
+    /**
+     * @brief Reserve
+     *
+     * Reserve the pools for the given number of additional decision nodes, each one having
+     * at most the given number of actions and being reached through a new outcome edge.
+     * A search iteration creates at most one decision node, hence reserving the number of
+     * iterations plus one guarantees that the pools are not reallocated during the search.
+     * @param {unsigned} nb_dnodes; number of additional decision nodes
+     * @param {unsigned} max_nb_actions; maximum number of actions of a decision node
+     */
+    void reserve(unsigned nb_dnodes, unsigned max_nb_actions) {
+        unsigned nb_cnodes = cnodes.size() + nb_dnodes * max_nb_actions;
+        dnodes.reserve(dnodes.size() + nb_dnodes);
+        outcomes.reserve(outcomes.size() + nb_dnodes);
+        actions.reserve(actions.size() + nb_dnodes * max_nb_actions);
+        cnodes.reserve(nb_cnodes);
+        visits.reserve(nb_cnodes);
+        means.reserve(nb_cnodes);
+        m2s.reserve(nb_cnodes);
+        pending.reserve(nb_cnodes);
+    }
+
+    /**
+     * @brief Reserve records
+     *
+     * Reserve the pools of the decision nodes, chance node slots, outcome edges and actions
+     * for the given number of elements each.
+     * A tree capped at a maximum number of records (see 'get_nb_records') exceeds it by at
+     * most one decision node and one children block, hence reserving the maximum plus the
+     * number of actions plus one guarantees that these pools are not reallocated while
+     * nodes are created; with the transposition table, outcome edges may still be added to
+     * a full tree.
+     * @param {unsigned} nb_records; number of elements of each pool
+     */
+    void reserve_records(unsigned nb_records) {
+        dnodes.reserve(nb_records);
+        outcomes.reserve(nb_records);
+        actions.reserve(nb_records);
+        cnodes.reserve(nb_records);
+        visits.reserve(nb_records);
+        means.reserve(nb_records);
+        m2s.reserve(nb_records);
+        pending.reserve(nb_records);
+    }
+
+    /**
+     * @brief Add decision node
+     *
+     * Create a decision node whose available actions are all the actions of the model,
+     * their validity at the given state being tested when they are drawn.
+     * @param {const state &} s; labelling state
+     * @param {const MD &} mod; model
+     * @param {unsigned} depth; depth of the node
+     * @return Return the indice of the created decision node.
+     */
+    template <class MD>
+    node_index add_dnode(const state &s, const MD &mod, unsigned depth) {
+        unsigned first = actions.size();
+        for(unsigned i=0; i<mod.action_space.size(); ++i) {
+            actions.push_back(i);
+        }
+        dnodes.emplace_back(s,first,mod.action_space.size(),depth);
+        return dnodes.size() - 1;
+    }
+
+    /**
+     * @brief Copy decision node
+     *
+     * Copy a decision node of another tree and its actions, without its children.
+     * @param {const mcts_tree &} src; source tree
+     * @param {node_index} v; indice of the decision node in the source tree
+     * @param {unsigned} depth; depth of the copy
+     * @return Return the indice of the copy.
+     */
+    node_index copy_dnode(const mcts_tree &src, node_index v, unsigned depth) {
+        const dnode &d = src.dnodes[v];
+        unsigned first = actions.size();
+        actions.insert(
+            actions.end(),
+            src.actions.begin() + d.first_action,
+            src.actions.begin() + d.first_action + d.nb_actions
+        );
+        dnodes.emplace_back(d.s,first,d.nb_actions,depth);
+        return dnodes.size() - 1;
+    }
+
+    /**
+     * @brief Extract subtree
+     *
+     * Copy the sub-graph reachable from a decision node into another tree, which is
+     * cleared first.
+     * The extracted root has depth 0 and the depths are shifted consequently.
+     * The statistics, the outcome index and the transposition table entries of the copied
+     * nodes are kept.
+     * @param {node_index} root; indice of the root of the extracted subtree
+     * @param {mcts_tree &} dst; destination tree
+     * @return Return the indice of the root in the destination tree.
+     */
+    node_index extract_subtree(node_index root, mcts_tree &dst) const {
+        dst.clear();
+        std::vector<node_index> dnode_map(dnodes.size(),NULL_INDEX);
+        std::vector<node_index> cnode_map(cnodes.size(),NULL_INDEX);
+        std::vector<node_index> pending(1,root);
+        unsigned depth0 = dnodes[root].depth;
+        dnode_map[root] = dst.copy_dnode(*this,root,0);
+        while(!pending.empty()) {
+            node_index v = pending.back();
+            pending.pop_back();
+            const dnode &d = dnodes[v];
+            if(d.nb_children == 0) {
+                continue;
+            }
+            node_index nv = dnode_map[v];
+            node_index first = dst.cnodes.size();
+            dst.dnodes[nv].first_child = first;
+            dst.dnodes[nv].nb_children = d.nb_children;
+            dst.cnodes.resize(first + d.nb_actions);
+            dst.visits.resize(dst.cnodes.size(),0);
+            dst.means.resize(dst.cnodes.size(),0.);
+            dst.m2s.resize(dst.cnodes.size(),0.);
+            dst.pending.resize(dst.cnodes.size(),0);
+            for(unsigned k=0; k<d.nb_children; ++k) {
+                node_index c = d.first_child + k;
+                node_index nc = first + k;
+                cnode_map[c] = nc;
+                dst.cnodes[nc] = cnode(nv,cnodes[c].action,cnodes[c].depth - depth0);
+                dst.visits[nc] = visits[c];
+                dst.means[nc] = means[c];
+                dst.m2s[nc] = m2s[c];
+                for(node_index e = cnodes[c].first_outcome; e != NULL_INDEX; e = outcomes[e].next) {
+                    node_index w = outcomes[e].child;
+                    if(dnode_map[w] == NULL_INDEX) {
+                        dnode_map[w] = dst.copy_dnode(*this,w,dnodes[w].depth - depth0);
+                        pending.push_back(w);
+                    }
+                    dst.outcomes.emplace_back(dnode_map[w],dst.cnodes[nc].first_outcome,outcomes[e].reward,outcomes[e].nb_samples);
+                    dst.cnodes[nc].first_outcome = dst.outcomes.size() - 1;
+                    ++dst.cnodes[nc].nb_outcomes;
+                }
+            }
+        }
+        outcome_index.for_each([&](const index_table::entry &e) {
+            if(cnode_map[e.owner] != NULL_INDEX) {
+                dst.outcome_index.insert(e.key,cnode_map[e.owner],dnode_map[e.value]);
+            }
+        });
+        transpositions.for_each([&](const index_table::entry &e) {
+            if(dnode_map[e.value] != NULL_INDEX) {
+                dst.transpositions.insert(e.key,e.owner,dnode_map[e.value]);
+            }
+        });
+        return dnode_map[root];
+    }
+
+    /**
+     * @brief Create child
+     *
+     * Create a child (hence a chance node) of a decision node.
+     * The action of the child is the next one of the action slice if the expansion is
+     * ordered, the slice being then validated by the ordering; else it is randomly drawn
+     * among the non-sampled actions, which are swapped at the end of the sampled prefix of
+     * the action slice, i.e. the slice is a lazily advanced random permutation.
+     * A drawn action leading to a wall is dropped at the end of the slice and another one
+     * is drawn, unless it is the last action of a node without children, in which case it
+     * is kept since every action leads to a wall.
+     * The children block is reserved in the chance node pool at the first call.
+     * @param {node_index} v; indice of the decision node, must not be fully expanded
+     * @param {const MD &} mod; model used for the validity of the actions
+     * @return Return the indice of the created chance node, NULL_INDEX if the remaining
+     * actions were all dropped.
+     */
+    template <class MD>
+    node_index create_child(node_index v, const MD &mod) {
+        dnode &d = dnodes[v];
+        assert(!d.is_fully_expanded());
+        if(d.nb_children == 0) { // reserve the children block
+            d.first_child = cnodes.size();
+            cnodes.resize(cnodes.size() + d.nb_actions);
+            visits.resize(cnodes.size(),0);
+            means.resize(cnodes.size(),0.);
+            m2s.resize(cnodes.size(),0.);
+            pending.resize(cnodes.size(),0);
+        }
+        unsigned k = d.first_action + d.nb_children;
+        while(!is_expansion_ordered) {
+            unsigned nb_candidates = d.nb_actions - d.nb_children;
+            unsigned j = k + rand_unsigned() % nb_candidates;
+            std::swap(actions[k],actions[j]);
+            if((nb_candidates == 1 && d.nb_children == 0) || mod.is_action_valid(d.s,mod.action_space[actions[k]])) {
+                break;
+            }
+            std::swap(actions[k],actions[d.first_action + d.nb_actions - 1]); // drop the action
+            --d.nb_actions;
+            if(d.is_fully_expanded()) {
+                return NULL_INDEX;
+            }
+        }
+        node_index c = d.first_child + d.nb_children;
+        cnodes[c] = cnode(v,actions[k],d.depth);
+        ++d.nb_children; // publish the child
+        return c;
+    }
+
+    /**
+     * @brief Add outcome
+     *
+     * Link a decision node as an outcome of a chance node and index it.
+     * @param {node_index} c; indice of the chance node
+     * @param {node_index} v; indice of the outcome decision node
+     * @param {std::uint64_t} key; hash of the state of the outcome
+     * @param {double} reward; reward of the transition to the outcome
+     */
+    void add_outcome(node_index c, node_index v, std::uint64_t key, double reward) {
+        outcomes.emplace_back(v,cnodes[c].first_outcome,reward);
+        cnodes[c].first_outcome = outcomes.size() - 1;
+        ++cnodes[c].nb_outcomes;
+        outcome_index.insert(key,c,v);
+    }
+
+    /**
+     * @brief Count outcome
+     *
+     * Increment the number of samples of an outcome of a chance node.
+     * Linear in the number of outcomes of the chance node.
+     * @param {node_index} c; indice of the chance node
+     * @param {node_index} v; indice of the outcome decision node
+     */
+    void count_outcome(node_index c, node_index v) {
+        for(node_index e = cnodes[c].first_outcome; e != NULL_INDEX; e = outcomes[e].next) {
+            if(outcomes[e].child == v) {
+                ++outcomes[e].nb_samples;
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Sample outcome
+     *
+     * Draw an outcome of a chance node with a probability proportional to its number of
+     * samples, which is then incremented.
+     * Linear in the number of outcomes of the chance node.
+     * @param {node_index} c; indice of the chance node, must have an outcome
+     * @param {double &} reward; set to the reward of the transition to the outcome
+     * @return Return the indice of the outcome decision node.
+     */
+    node_index sample_outcome(node_index c, double &reward) {
+        unsigned total = 0;
+        for(node_index e = cnodes[c].first_outcome; e != NULL_INDEX; e = outcomes[e].next) {
+            total += outcomes[e].nb_samples;
+        }
+        unsigned r = rand_unsigned() % total;
+        node_index e = cnodes[c].first_outcome;
+        for(unsigned n = outcomes[e].nb_samples; n <= r; n += outcomes[e].nb_samples) {
+            e = outcomes[e].next;
+        }
+        ++outcomes[e].nb_samples;
+        reward = outcomes[e].reward;
+        return outcomes[e].child;
+    }
+
+    /**
+     * @brief Update value
+     *
+     * Update the statistics of a chance node with a new sampled return.
+     * The update is not atomic as a whole, concurrent updates of the same node must be
+     * serialized by the caller.
+     * @param {node_index} c; indice of the chance node
+     * @param {double} q; sampled return
+     */
+    void update_value(node_index c, double q) {
+        unsigned n = visits[c];
+        double mean = means[c];
+        double m2 = m2s[c];
+        welford_update(n,mean,m2,q);
+        means[c] = mean;
+        m2s[c] = m2;
+        visits[c] = n;
+    }
+
+    /** @brief Get the number of visits of a chance node */
+    unsigned get_nb_visits(node_index c) const {
+        return visits[c];
+    }
+
+    /** @brief Get the value of a chance node ie the mean of its sampled returns */
+    double get_value(node_index c) const {
+        return means[c];
+    }
+
+    /** @brief Get the variance of the sampled returns of a chance node */
+    double get_variance(node_index c) const {
+        unsigned n = visits[c];
+        return (n == 0) ? 0. : m2s[c] / ((double) n);
+    }
+
+    /**
+     * @brief Get decision node visits
+     *
+     * Get the number of visits of a decision node, this is the sum of the number of
+     * visits of its children.
+     * @param {node_index} v; indice of the decision node
+     * @return Return the number of visits of the node.
+     */
+    unsigned get_dnode_nb_visits(node_index v) const {
+        const dnode &d = dnodes[v];
+        unsigned n = 0;
+        for(node_index c = d.first_child; c < d.first_child + d.nb_children; ++c) {
+            n += visits[c];
+        }
+        return n;
+    }
+
+    /**
+     * @brief Get number of chance nodes
+     *
+     * Get the number of created chance nodes, the reserved slots being excluded.
+     * @return Return the number of chance nodes.
+     */
+    unsigned get_nb_cnodes() const {
+        unsigned n = 0;
+        for(auto &d : dnodes) {
+            n += d.nb_children;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Get number of records
+     *
+     * Get the number of records stored by the tree: decision nodes, chance node slots,
+     * outcome edges, actions, and entries of the outcome index and of the transposition
+     * table.
+     * @return Return the number of records.
+     */
+    unsigned get_nb_records() const {
+        return dnodes.size() + cnodes.size() + outcomes.size() + actions.size()
+            + outcome_index.nb_entries + transpositions.nb_entries;
+    }
+
+    /**
+     * @brief Get decision node value
+     *
+     * Get the value of a decision node, this is the maximum value of its children.
+     * @param {node_index} v; indice of the decision node, must have children
+     * @return Return the value of the node.
+     */
+    double get_dnode_value(node_index v) const {
+        const dnode &d = dnodes[v];
+        double value = get_value(d.first_child);
+        for(node_index c = d.first_child + 1; c < d.first_child + d.nb_children; ++c) {
+            value = std::max(value,get_value(c));
+        }
+        return value;
+    }
+};
+
+#endif // MCTS_TREE_HPP_
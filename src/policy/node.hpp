@@ -1,6 +1,8 @@
 #ifndef NODE_HPP_
 #define NODE_HPP_
 
+#include <running_statistics.hpp>
+
 /**
  * @brief Node class
  *
@@ -12,9 +14,10 @@ private :
     unsigned visits_count; ///< Number of visits during the tree expansion
     state s; ///<Unique labelling state for a root node
     std::shared_ptr<action> incoming_action; ///< Action of the parent node that led to this node
-    std::vector<double> sampled_outcomes; ///< Sampled outcomes (returns)
+    running_statistics outcomes; ///< Running statistics of the sampled outcomes (returns)
     std::vector<state> sampled_states; ///< Sampled states for a standard node
-    std::vector<std::shared_ptr<action>> local_action_space; ///< Available actions at this node (bandit arms)
+    std::vector<std::shared_ptr<action>> local_action_space; ///< Available actions at this node (bandit arms), empty until the second expansion of a non-root node
+    unsigned nb_actions; ///< Number of available actions
 
 public :
     node *parent; ///< Pointer to the parent node
@@ -29,10 +32,10 @@ public :
      * @brief Root node constructor
      *
      * Usually the first node to be created.
-     * The provided action space is a vector containing all the actions and is
-     * shuffled at the nodes creation.
-     * @param {std::vector<std::shared_ptr<action>>} _local_action_space; copied then shuffled in
-     * local action space of the node (bandit arms)
+     * The provided action space is a vector containing all the actions, the expansion
+     * order being drawn as the node is expanded (see 'draw_expansion_action').
+     * @param {std::vector<std::shared_ptr<action>>} _local_action_space; copied in local
+     * action space of the node (bandit arms)
      */
     node(
         state _state,
@@ -41,7 +44,7 @@ public :
     {
         root = true;
         local_action_space = _local_action_space;
-        shuffle(local_action_space);
+        nb_actions = local_action_space.size();
         visits_count = 0;
     }
 
@@ -49,22 +52,21 @@ public :
      * @brief Non-root node constructor
      *
      * Used during the expansion of the tree.
-     * @param {std::vector<std::shared_ptr<action>>} _local_action_space; copied then shuffled in
-     * actions of the node (bandit arms)
+     * The action space is not copied until it is needed (see 'draw_expansion_action').
+     * @param {unsigned} _nb_actions; number of actions of the node (bandit arms)
      */
     node(
         node * _parent,
         std::shared_ptr<action> _incoming_action,
         state _new_state,
-        std::vector<std::shared_ptr<action>> _local_action_space) :
+        unsigned _nb_actions) :
         incoming_action(_incoming_action),
         parent(_parent)
     {
         root = false;
         visits_count = 0;
         sampled_states.push_back(_new_state);
-        local_action_space = _local_action_space;
-        shuffle(local_action_space);
+        nb_actions = _nb_actions;
     }
 
     /**
@@ -81,7 +83,7 @@ public :
         visits_count = 0;
         s.set_to_default();
         //incoming_action->set_to_default();
-        sampled_outcomes.clear();
+        outcomes.clear();
         sampled_states.clear();
         children.clear();
     }
@@ -112,13 +114,14 @@ public :
         return &children.at(indice);
     }
 
-    /** @brief Get the value of the node */
+    /** @brief Get the value of the node ie the mean of the sampled outcomes */
     double get_value() const {
-        double value = 0.;
-        for(auto &r : sampled_outcomes) {
-            value += r;
-        }
-        return value / ((double) visits_count);
+        return outcomes.get_mean();
+    }
+
+    /** @brief Get the variance of the sampled outcomes of the node */
+    double get_outcome_variance() const {
+        return outcomes.get_variance();
     }
 
     /** @brief Get the state of the node (root node) */
@@ -138,11 +141,6 @@ public :
         return sampled_states;
     }
 
-    /** @brief Get a copy of the sampled outcomes of the node */
-    std::vector<double> get_sampled_outcomes() const {
-        return sampled_outcomes;
-    }
-
     /** @brief Get a copy of the last sampled state among the states family (non-root node) */
     state get_last_sampled_state() const {
         assert(!root);
@@ -172,6 +170,61 @@ public :
     /** @brief Set the action space */
     void set_action_space(std::vector<std::shared_ptr<action>> as) {
         local_action_space = as;
+        nb_actions = local_action_space.size();
+    }
+
+    /**
+     * @brief Build action space
+     *
+     * Copy the given action space if the node has none yet, the actions of the existing
+     * children being moved at the front so that the ith child is labelled by the ith action.
+     * @param {const std::vector<std::shared_ptr<action>> &} as; action space
+     */
+    void build_action_space(const std::vector<std::shared_ptr<action>> &as) {
+        if(!local_action_space.empty()) {
+            return;
+        }
+        local_action_space = as;
+        nb_actions = local_action_space.size();
+        for(unsigned i=0; i<children.size(); ++i) {
+            for(unsigned j=i; j<nb_actions; ++j) {
+                if(local_action_space[j] == children[i].incoming_action) {
+                    std::swap(local_action_space[i],local_action_space[j]);
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Draw expansion action
+     *
+     * Get the action of the next child among the available actions.
+     * If the expansion is not ordered, the action is drawn at random among the actions not
+     * sampled yet, which are swapped at the end of the sampled prefix of the action space,
+     * i.e. the action space is a lazily advanced random permutation.
+     * The action space of a non-root node is only built at its second expansion, since the
+     * first action is simply drawn in the given action space.
+     * @param {const std::vector<std::shared_ptr<action>> &} as; action space of the node
+     * @param {bool} is_ordered; is the action space in the order of expansion
+     * @return Return the action of the next child.
+     */
+    std::shared_ptr<action> draw_expansion_action(
+        const std::vector<std::shared_ptr<action>> &as,
+        bool is_ordered)
+    {
+        unsigned k = children.size();
+        if(local_action_space.empty()) {
+            if(k == 0 && !is_ordered) {
+                return as[rand_indice(as)];
+            }
+            build_action_space(as);
+        }
+        if(!is_ordered) {
+            unsigned j = k + rand_unsigned() % (nb_actions - k);
+            std::swap(local_action_space[k],local_action_space[j]);
+        }
+        return local_action_space[k];
     }
 
     /** @brief Shuffle the action space */
@@ -179,24 +232,40 @@ public :
         shuffle(local_action_space);
     }
 
+    /**
+     * @brief Order action space
+     *
+     * Sort the action space by decreasing score, hence the order of expansion; the
+     * actions with equal scores keep their current (shuffled) order.
+     * @param {F} score; function giving the score of an action
+     */
+    template <class F>
+    void order_action_space(F score) {
+        std::vector<std::pair<double,std::shared_ptr<action>>> scored;
+        for(auto &a : local_action_space) {
+            scored.emplace_back(score(a),a);
+        }
+        std::stable_sort(scored.begin(),scored.end(),[](const auto &x, const auto &y) {
+            return x.first > y.first;
+        });
+        for(unsigned i=0; i<scored.size(); ++i) {
+            local_action_space[i] = scored[i].second;
+        }
+    }
+
     /** @brief Get a copy of the actions vector */
     std::vector<std::shared_ptr<action>> get_action_space() const {
         return local_action_space;
     }
 
-    /** @brief Get one action of the node given its indice in the actions vector */
+    /** @brief Get the action of a child given its indice, which is also its indice in the actions vector */
     std::shared_ptr<action> get_action_at(unsigned indice) const {
-        return local_action_space.at(indice);
-    }
-
-    /** @brief Get the next expansion action among the available actions */
-    std::shared_ptr<action> get_next_expansion_action() const {
-        return local_action_space.at(children.size());
+        return children.at(indice).incoming_action;
     }
 
     /** @brief Get the number of actions (arms of the bandit) */
     unsigned get_nb_of_actions() const {
-        return local_action_space.size();
+        return nb_actions;
     }
 
     /** @brief Is fully expanded @return Return true if the node is fully expanded */
@@ -216,14 +285,14 @@ public :
      * Create a child based on the incoming action.
      * @param {std::shared_ptr<action> &} inc_ac; incoming action of the new child
      * @param {state &} state; first sampled state of the new child
-     * @param {std::vector<std::shared_ptr<action>>} as; action space
+     * @param {unsigned} nb_child_actions; number of actions of the new child
      */
     void create_child(
         std::shared_ptr<action> &inc_ac,
         state &s,
-        std::vector<std::shared_ptr<action>> as)
+        unsigned nb_child_actions)
     {
-        children.emplace_back(node(this,inc_ac,s,as));
+        children.emplace_back(node(this,inc_ac,s,nb_child_actions));
     }
 
     /**
@@ -248,6 +317,18 @@ public :
         sampled_states.push_back(s);
     }
 
+    /**
+     * @brief Replace last state
+     *
+     * Replace the last sampled state by a new one, the number of states being unchanged.
+     * Node should not be root and should have a sampled state.
+     * @param {const state &} s; new state
+     */
+    void replace_last_state(const state &s) {
+        assert(!root && !sampled_states.empty());
+        sampled_states.back() = s;
+    }
+
     /**
      * @brief Visit count increment
      *
@@ -260,13 +341,13 @@ public :
     /**
      * @brief Add to value
      *
-     * Add a sample to the sampled outcome.
+     * Add a sample to the sampled outcome statistics.
      * Node should not be root.
      * @param {double} r; outcome sample value to be added
      */
     void add_to_value(double r) {
         assert(!root);
-        sampled_outcomes.push_back(r);
+        outcomes.add(r);
     }
 
     /**
@@ -280,9 +361,10 @@ public :
     void move_to_child(unsigned indice, const state &new_state) {
         assert(is_root());
         local_action_space = children[indice].get_action_space();
+        nb_actions = children[indice].get_nb_of_actions();
         sampled_states = children[indice].get_sampled_states();
         visits_count = children[indice].get_visits_count();
-        sampled_outcomes = children[indice].get_sampled_outcomes();
+        outcomes = children[indice].outcomes;
         auto tmp = std::move(children[indice].children); // Temporary variable to prevent from overwriting
         for(auto &elt : tmp) {
             elt.parent = this;
@@ -90,18 +90,11 @@ public:
      *
      * Test whether the variance of the outcome distribution at the node reached by the
      * recommended action is small enough.
+     * The variance is read from the running statistics of the node in O(1).
      * @return Return true if the test does not discard the tree.
      */
     bool outcome_distribution_variance_test() {
-        std::vector<double> outcomes = pl.root_node.get_sampled_outcomes();
-        double variance = 0.;
-        for(unsigned i=0; i<outcomes.size(); ++i) {
-            for(unsigned j=0; j<i; ++j) {
-                variance += pow(outcomes[i] = outcomes[j], 2.);
-            }
-        }
-        variance /= pow(((double) outcomes.size()),2.);
-        return is_less_than(variance,rdv_threshold);
+        return is_less_than(pl.root_node.get_outcome_variance(),rdv_threshold);
     }
 
     bool are_states_equal(const state &a, const state &b) const {
@@ -199,6 +192,58 @@ public:
         return keep_tree;
     }
 
+    /**
+     * @brief Stop search
+     *
+     * Request the end of the current search of the embedded OLUCT policy.
+     * May be called from any thread.
+     */
+    void stop_search() {
+        pl.stop_search();
+    }
+
+    /**
+     * @brief Clear stop
+     *
+     * Clear the request of 'stop_search', before a new search.
+     */
+    void clear_stop() {
+        pl.clear_stop();
+    }
+
+    /**
+     * @brief Search
+     *
+     * Same as the policy operator, the model of the embedded OLUCT policy not being updated
+     * by OLTA, see 'mcts::search'.
+     * @param {const state &} s; state of the agent
+     * @return Return the recommended action at s.
+     */
+    std::shared_ptr<action> search(const state &s) {
+        return (*this)(s);
+    }
+
+    /**
+     * @brief Update model
+     *
+     * Nothing to do, see 'search'.
+     * @param {const state &} s; current state of the agent
+     */
+    void update_model(const state &s) {
+        (void) s;
+    }
+
+    /**
+     * @brief Discard search
+     *
+     * Drop the last search, whose state was not reached: the root, moved to the child of the
+     * recommended action, is cleared so that the tree is rebuilt at the next decision.
+     */
+    void discard_search() {
+        pl.root_node.clear_node();
+        pl.halving_arms.clear();
+    }
+
     /**
      * @brief Policy operator
      *
@@ -207,12 +252,13 @@ public:
      * @return Return the undertaken action at s.
      */
 	std::shared_ptr<action> operator()(const state &s) {
-        if(!pl.root_node.is_fully_expanded() || !decision_criterion(s)) {
+        if(!pl.is_widened(pl.root_node) || !decision_criterion(s)) {
             pl.build_oluct_tree(s);
         }
         unsigned indice = 0;
         std::shared_ptr<action> ra = pl.get_recommended_action(pl.root_node,indice);
         pl.root_node.move_to_child(indice,s);
+        pl.halving_arms.clear(); // the arms of a sequential halving were children of the previous root
         return ra;
 	}
 
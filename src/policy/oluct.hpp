@@ -4,6 +4,10 @@
 #include <environment.hpp>
 #include <node.hpp>
 #include <random.hpp>
+#include <rollout_engine.hpp>
+#include <atomic_value.hpp>
+#include <deadline.hpp>
+#include <thread_pool.hpp>
 
 /**
  * @brief OLUCT policy
@@ -13,6 +17,15 @@ class oluct {
 public:
     typedef PL PL_type;
 
+    /**
+     * @brief Step of a descent
+     */
+    class step {
+    public:
+        node * v; ///< Node reached
+        double reward; ///< Reward of the transition from the parent node to v
+    };
+
     PL dflt_policy; ///< Default policy
     environment model; ///< Copy of the environment, used for action space reduction, termination criterion and generative model, also its attributes may be changed according to the used configuration
     node root_node; ///< Root node of the tree
@@ -20,9 +33,26 @@ public:
     double discount_factor; ///< MDP discount factor
     unsigned horizon; ///< Horizon for default policy
     unsigned budget; ///< Algorithm budget (number of expanded nodes)
+    deadline time_limit; ///< Time budget of a decision, the budget still bounds the number of iterations
+    unsigned early_stop_period; ///< Number of iterations between two tests of the stopping rule, 0 to disable
+    double early_stop_z; ///< Confidence quantile of the stopping rule
+    unsigned nb_searches; ///< Number of built trees
+    double nb_iterations_spent; ///< Number of search iterations run, summed over the built trees
     unsigned expd_counter; ///< Counter of the number of expanded nodes
-    unsigned nb_calls; ///< Number of calls to the generative model
+    unsigned max_nb_records; ///< Maximum number of records of the tree (nodes, sampled states and actions), 0 for no limit
+    unsigned nb_records; ///< Number of records of the tree, the children block of a node being counted at its first expansion
+    bool is_tree_full; ///< Set once a descent reached a leaf whose children block does not fit in the tree, which ends the search
+    atomic_value<unsigned> nb_calls; ///< Number of calls to the generative model
     bool is_model_dynamic; ///< Is the model dynamic
+    double pw_coefficient; ///< Progressive widening: a node visited n times has at most pw_coefficient * n^pw_exponent children, 0 to disable
+    double pw_exponent; ///< Progressive widening exponent
+    bool is_expansion_ordered; ///< Expand the actions by decreasing nominal reward instead of randomly
+    bool is_halving; ///< Sequential halving at the root, UCT below (mcts_strategy_switch = 2)
+    std::vector<unsigned> halving_arms; ///< Indices of the root children remaining in the last sequential halving
+    unsigned nb_leaf_rollouts; ///< Number of default policy rollouts averaged at each leaf
+    std::unique_ptr<thread_pool> rollout_pool; ///< Threads running the rollouts of a leaf, null for a single rollout
+    std::vector<step> path; ///< Nodes reached during the current descent, from the root child to the leaf
+    rollout_engine rollouts; ///< Simulation of the default policy
 
     /**
      * @brief Constructor
@@ -39,12 +69,29 @@ public:
         model.misstep_probability = p.MODEL_MISSTEP_PROBABILITY;
         model.state_gaussian_stddev = p.MODEL_STATE_GAUSSIAN_STDDEV;
         budget = p.TREE_SEARCH_BUDGET;
+        time_limit.duration_ms = p.DECISION_TIME_LIMIT;
+        early_stop_period = p.EARLY_STOP_PERIOD;
+        early_stop_z = p.EARLY_STOP_Z;
+        nb_searches = 0;
+        nb_iterations_spent = 0.;
         expd_counter = 0;
+        max_nb_records = (p.MAX_TREE_RECORDS == 0) ? 0 : std::max<unsigned>(p.MAX_TREE_RECORDS,1 + 3 * model.action_space.size()); // room for the root, its actions and its children block
+        nb_records = 0;
+        is_tree_full = false;
         nb_calls = 0;
         uct_cst = p.UCT_CST;
         discount_factor = p.DISCOUNT_FACTOR;
         horizon = p.DEFAULT_POLICY_HORIZON;
         is_model_dynamic = p.IS_MODEL_DYNAMIC;
+        pw_coefficient = p.PW_COEFFICIENT;
+        pw_exponent = p.PW_EXPONENT;
+        is_expansion_ordered = p.PW_HEURISTIC_ORDERING;
+        is_halving = (p.MCTS_STRATEGY_SWITCH == 2);
+        nb_leaf_rollouts = std::max(1u,p.NB_LEAF_ROLLOUTS);
+        if(nb_leaf_rollouts > 1) { // leaf parallelization
+            rollout_pool.reset(new thread_pool(nb_leaf_rollouts - 1));
+        }
+        rollouts = rollout_engine(discount_factor,horizon,is_model_dynamic,p.ROLLOUT_TRUNCATION_EPSILON);
     }
 
     /**
@@ -92,7 +139,7 @@ public:
      * @brief State sampling
      *
      * Sample a new state w.r.t. to the incoming action and the parents state and add it to
-     * the node.
+     * the node, or replace its last state with it if the tree has no room for it.
      * @param {node *} v; pointer to the node
      * @return Return sampled state
      */
@@ -101,25 +148,106 @@ public:
         std::shared_ptr<action> a = v->get_incoming_action();
         state s = (v->parent)->get_state_or_last();
         state s_p = generative_model(s,a,md);
-        v->add_to_states(s_p);
+        if(!has_room(1)) { // no room for a new state, it replaces the last one
+            v->replace_last_state(s_p);
+        } else {
+            v->add_to_states(s_p);
+            ++nb_records;
+        }
         return s_p;
     }
 
+    /**
+     * @brief Is widened
+     *
+     * Test whether a node has as many children as allowed.
+     * Without progressive widening, this is the full expansion test; with progressive
+     * widening, a node visited n times may have ceil(pw_coefficient * n^pw_exponent)
+     * children (at least one), the visits of the root being the iterations.
+     * The root of a sequential halving is fully expanded.
+     * @param {const node &} v; tested node
+     * @return Return true if no child may be created.
+     */
+    bool is_widened(const node &v) const {
+        if(v.is_fully_expanded()) {
+            return true;
+        }
+        if(pw_coefficient <= 0. || (is_halving && v.is_root())) {
+            return false;
+        }
+        double n = v.is_root() ? expd_counter : v.get_visits_count();
+        return v.get_nb_children() >= std::max(1.,std::ceil(pw_coefficient * pow(n,pw_exponent)));
+    }
+
+    /**
+     * @brief Order actions
+     *
+     * Order the actions of a node by decreasing nominal reward at the given state if the
+     * expansion is ordered; the actions being shuffled beforehand, ties are broken randomly.
+     * @param {node &} v; node, whose action space is built
+     * @param {const state &} s; state of the node
+     */
+    void order_actions(node &v, const state &s) const {
+        if(is_expansion_ordered) {
+            v.shuffle_action_space();
+            v.order_action_space([&](const std::shared_ptr<action> &a) {
+                return model.nominal_reward(s,a);
+            });
+        }
+    }
+
+    /**
+     * @brief Has room
+     *
+     * Test whether records may be added to the tree without exceeding its maximum number of
+     * records.
+     * @param {unsigned} nb_new_records; number of added records
+     * @return Return true if the records may be added.
+     */
+    bool has_room(unsigned nb_new_records) const {
+        return max_nb_records == 0 || nb_records + nb_new_records <= max_nb_records;
+    }
+
+    /**
+     * @brief Children block size
+     *
+     * Number of records of the children of a node: a node and its first sampled state per
+     * action and, below the root, the action space, which is built lazily.
+     * @param {const node &} v; node
+     * @return Return the number of records.
+     */
+    unsigned children_block_size(const node &v) const {
+        return (v.is_root() ? 2 : 3) * v.get_nb_of_actions();
+    }
+
     /**
      * @brief Expansion method
      *
      * Expand the node i.e. create a new leaf node.
+     * The action space of a non-root node is only built when needed, i.e. at its first
+     * expansion if the expansion is ordered, else at its second one (see
+     * 'node::draw_expansion_action').
+     * The children block of the node is counted and reserved at its first expansion, hence
+     * the children keep their address, which their own children point to.
      * @param {node &} v; reference on the expanded node
      * @return Return a pointer to the created leaf node
      */
     node * expand(node &v, environment &md) {
-        std::shared_ptr<action> nodes_action = v.get_next_expansion_action();
+        if(v.get_nb_children() == 0) {
+            nb_records += children_block_size(v);
+            v.children.reserve(v.get_nb_of_actions());
+        }
         state nodes_state = v.get_state_or_last();
+        if(is_expansion_ordered && !v.is_root() && v.get_nb_children() == 0) {
+            v.build_action_space(md.action_space); //TODO: warning - stochastic case
+            order_actions(v,nodes_state);
+        }
+        std::shared_ptr<action> nodes_action = v.draw_expansion_action(md.action_space,is_expansion_ordered);
         state new_state = generative_model(nodes_state,nodes_action,md);
         v.create_child(
             nodes_action,
             new_state,
-            md.action_space //TODO: warning - stochastic case
+            md.action_space.size()
         );
         return v.get_last_child();
     }
@@ -128,41 +256,85 @@ public:
      * @brief UCT child
      *
      * UCT selection method for the tree policy.
+     * The exploration factor is computed once per node and 1/sqrt(visits) is read from a
+     * precomputed table; the ties are broken by reservoir sampling, nothing is allocated.
      * @param {node &} v; parent node
      * @return Return the selected child according to the UCT formula
      */
     node * uct_child(node &v) const {
-        std::vector<double> uct_scores;
-        for(auto &c : v.children) {
-            assert(c.get_visits_count() != 0 && expd_counter > 0);
-            uct_scores.emplace_back(
-                c.get_value() + 2 * uct_cst *
-                sqrt(log((double) expd_counter)/ ((double) c.get_visits_count()))
-            );
-        }
-        return &v.children.at(argmax(uct_scores));
+        assert(expd_counter > 0);
+        double exploration = 2 * uct_cst * sqrt(log((double) expd_counter));
+        return &v.children.at(argmax_of(v.children.size(),[&](unsigned i) {
+            const node &c = v.children[i];
+            assert(c.get_visits_count() != 0);
+            return c.get_value() + exploration * inverse_sqrt(c.get_visits_count());
+        }));
+    }
+
+    /**
+     * @brief Halving child
+     *
+     * Root child of a sequential halving round: the remaining child with the fewest visits,
+     * see 'mcts::halving_strategy'.
+     * @return Return the selected child.
+     */
+    node * halving_child() {
+        return &root_node.children.at(halving_arms[argmax_of(halving_arms.size(),[&](unsigned i) {
+            return -((double) root_node.children[halving_arms[i]].get_visits_count());
+        })]);
+    }
+
+    /**
+     * @brief Transition reward
+     *
+     * Reward of the transition from the parent of a node to its last sampled state.
+     * @param {const node &} v; non-root node
+     * @return Return the reward.
+     */
+    double transition_reward(const node &v) {
+        return model.reward_function(
+            v.parent->get_state_or_last(),
+            v.get_incoming_action(),
+            v.get_last_sampled_state()
+        );
     }
 
     /**
      * @brief Tree policy
      *
      * Apply the tree policy.
-     * Recursive method.
-     * @param {node &} v;
-     * @return Return a pointer to the created leaf node or to the current node if terminal.
-     */
-    node * tree_policy(node &v, environment &md) {
-        if(is_node_terminal(v,md)) { // terminal
-            sample_new_state(&v,md);
-            return &v;
-        } else if(!v.is_fully_expanded()) { // expand node
-            return expand(v,md);
-        } else { // apply UCT tree policy
-            node * v_p = uct_child(v);
-            if(is_model_dynamic) {
-                md.step(sample_new_state(v_p,md));
+     * Iterative method: the reached nodes and the rewards of their transitions are recorded
+     * in the path during the descent, for the backup.
+     * A leaf whose children block does not fit in the tree is evaluated without expansion
+     * and the tree is then full; the states sampled along a descent replace the last ones
+     * of their nodes once there is no room for them (see 'sample_new_state').
+     * @param {node &} v0; starting node
+     * @return Return a pointer to the created leaf node, to the reached leaf if the tree is
+     * full or to the current node if terminal.
+     */
+    node * tree_policy(node &v0, environment &md) {
+        path.clear();
+        node * v = &v0;
+        for(;;) {
+            if(is_node_terminal(*v,md)) { // terminal
+                sample_new_state(v,md);
+                path.back().reward = transition_reward(*v); // the last sampled state of v changed
+                return v;
+            } else if(!is_widened(*v) && (v->get_nb_children() > 0 || has_room(children_block_size(*v)))) { // expand node
+                node * leaf = expand(*v,md);
+                path.push_back(step{leaf,transition_reward(*leaf)});
+                return leaf;
+            } else if(v->get_nb_children() == 0) { // leaf node, no room for its children
+                is_tree_full = true;
+                return v;
+            } else { // apply UCT tree policy, or sequential halving at the root
+                node * v_p = (v == &root_node && !halving_arms.empty()) ? halving_child() : uct_child(*v);
+                if(is_model_dynamic) {
+                    md.step(sample_new_state(v_p,md));
+                }
+                path.push_back(step{v_p,transition_reward(*v_p)});
+                v = v_p;
             }
-            return tree_policy(*v_p,md);
         }
     }
 
@@ -171,6 +343,8 @@ public:
      *
      * Compute the total return by running an episode with the default policy.
      * The simulation starts from the last sampled state of the input node.
+     * With several leaf rollouts, the episodes run in parallel, from copies of the model if
+     * dynamic, and their mean is returned.
      * @param {node *} ptr; pointer to the input node
      * @return Return the sampled total return.
      */
@@ -180,43 +354,50 @@ public:
             std::shared_ptr<action> a(new navigation_action()); // default action
             return md.reward_function(s,a,s);
         }
-        double total_return = 0.;
-        std::shared_ptr<action> a = dflt_policy(s);
-        for(unsigned t=0; t<horizon; ++t) {
-            state s_p = generative_model(s,a,md);
-            total_return += pow(discount_factor,(double)t) * md.reward_function(s,a,s_p);
-            if(md.is_terminal(s_p)) { // Termination criterion
-                break;
-            }
+        if(!rollout_pool) {
+            return rollout(s,md);
+        }
+        std::vector<double> returns(nb_leaf_rollouts);
+        rollout_pool->seeded_parallel_for(nb_leaf_rollouts,[&](unsigned k) {
             if(is_model_dynamic) {
-                md.step(s_p);
+                environment rollout_model(md);
+                returns[k] = rollout(s,rollout_model);
+            } else {
+                returns[k] = rollout(s,md);
             }
-            s = s_p;
-            a = dflt_policy(s);
-        }
+        });
+        return std::accumulate(returns.begin(),returns.end(),0.) / ((double) nb_leaf_rollouts);
+    }
+
+    /**
+     * @brief Rollout
+     *
+     * Run an episode with the default policy and compute the discounted return, each
+     * simulated step counting as a call to the generative model.
+     * @param {const state &} s; starting state
+     * @param {environment &} md; model, updated along the episode if dynamic
+     * @return Return the sampled total return.
+     */
+    double rollout(const state &s, environment &md) {
+        unsigned nb_steps = 0;
+        double total_return = rollouts.run(s,dflt_policy(s),md,dflt_policy,nb_steps);
+        nb_calls += nb_steps;
         return total_return;
     }
 
     /**
      * @brief Backup method
      *
-     * Increment all the visited nodes visits counters and update their values w.r.t. the
-     * given discounted return.
-     * This method is recursive.
-     * @param {double &} total_return; return to be backed up, iteratively discounted
-     * @param {node *} ptr; pointer to the node, first the leaf node, then to the parents
-     */
-    void backup(double &total_return, node * ptr) {
-        ptr->increment_visits_count();
-        ptr->add_to_value(total_return);
-        total_return *= discount_factor; // apply the discount for the parent node
-        total_return += model.reward_function( // add the reward of the transition //TODO replace this like mcts algorithm implementation (recursive calls, no backup)
-            ptr->parent->get_state_or_last(),
-            ptr->get_incoming_action(),
-            ptr->get_last_sampled_state()
-        );
-        if(!ptr->parent->is_root()) {
-            backup(total_return,ptr->parent);
+     * Increment the visits counters of the nodes of the path of the last descent and update
+     * their values w.r.t. the given discounted return, from the leaf to the root child.
+     * The rewards of the transitions are those recorded during the descent.
+     * @param {double} total_return; return to be backed up, iteratively discounted
+     */
+    void backup(double total_return) {
+        for(auto it = path.rbegin(); it != path.rend(); ++it) {
+            it->v->increment_visits_count();
+            it->v->add_to_value(total_return);
+            total_return = discount_factor * total_return + it->reward; // discount for the parent node and add the reward of the transition
         }
     }
 
@@ -234,27 +415,119 @@ public:
         }
     }
 
+    /**
+     * @brief Is search decided
+     *
+     * Stopping rule, tested every 'early_stop_period' iterations: the search is decided once
+     * every action of the root is expanded and the child of maximum value is separated from
+     * the other ones (see 'is_best_arm_separated').
+     * @param {unsigned} k; number of iterations run
+     * @return Return true if the search may stop.
+     */
+    bool is_search_decided(unsigned k) const {
+        if(early_stop_period == 0 || k == 0 || k % early_stop_period != 0 || !root_node.is_fully_expanded()) {
+            return false;
+        }
+        return is_best_arm_separated(root_node.get_nb_children(),early_stop_z,[&](unsigned i, unsigned &n, double &mean, double &variance) {
+            const node &c = root_node.children[i];
+            n = c.get_visits_count();
+            mean = c.get_value();
+            variance = c.get_outcome_variance();
+        });
+    }
+
+    /**
+     * @brief Iterate
+     *
+     * Run search iterations until the given number of iterations of the search is reached,
+     * the time limit expires, the stopping rule is met or the tree is full, at least one
+     * iteration being run by the search.
+     * The search stops with a full tree since its branches are then cut at different
+     * depths: the iterations would go on refining the values of the deepest ones, the other
+     * ones being only evaluated by the default policy, which biases the recommendation
+     * towards the branches that happened to be expanded before the tree was full.
+     * @param {unsigned} nb_iterations; number of iterations of the search to reach
+     * @return Return true if the number of iterations was reached.
+     */
+    bool iterate(unsigned nb_iterations) {
+        for(; expd_counter<nb_iterations; ++expd_counter) {
+            if(expd_counter > 0 && time_limit.is_expired()) {
+                return false;
+            }
+            if(is_search_decided(expd_counter) || is_tree_full) {
+                return false;
+            }
+            if(is_model_dynamic) { // the iteration updates its own copy of the model
+                environment cp = model.get_copy();
+                node *ptr = tree_policy(root_node,cp);
+                backup(default_policy(ptr,cp));
+            } else { // the model is only read
+                node *ptr = tree_policy(root_node,model);
+                backup(default_policy(ptr,model));
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Sequential halving
+     *
+     * Search for a simple-regret decision at the root, see 'mcts::sequential_halving': the
+     * children of the root are created first, then the remaining iterations are split into
+     * rounds, the lower half of the remaining children being dropped after each one; with a
+     * time limit, each round also gets an even share of the remaining time.
+     */
+    void sequential_halving() {
+        while(!is_widened(root_node) && expd_counter < budget) { // an iteration creates a child
+            unsigned nb_children = root_node.get_nb_children();
+            if(!iterate(expd_counter + 1) || root_node.get_nb_children() == nb_children) { // stopped, or terminal root
+                return;
+            }
+        }
+        for(unsigned i=0; i<root_node.get_nb_children(); ++i) {
+            halving_arms.push_back(i);
+        }
+        for(unsigned nb_rounds = nb_halving_rounds(halving_arms.size()); nb_rounds > 0; --nb_rounds) {
+            deadline::clock::time_point decision_end = time_limit.share(nb_rounds);
+            bool is_round_over = iterate(expd_counter + (budget - expd_counter) / nb_rounds) || time_limit.is_expired();
+            time_limit.end = decision_end;
+            if(!is_round_over) { // stopping rule met or full tree within the round
+                return;
+            }
+            halve_arms(halving_arms,[&](unsigned i) {return root_node.children[i].get_value();});
+            if(time_limit.is_expired()) {
+                return;
+            }
+        }
+    }
+
     /**
      * @brief Build OLUCT tree
      *
-     * Build a tree wrt the OLUCT algorithm.
+     * Build a tree wrt the OLUCT algorithm, or by sequential halving at the root.
      * The tree is kept in memory.
+     * The search ends after 'budget' iterations, when the time limit expires, when the
+     * stopping rule is met or when the tree is full, at least one iteration being run.
      * @param {const state &} s; current state of the agent
      */
     void build_oluct_tree(const state &s) {
+        time_limit.start();
         root_node.clear_node();
         root_node.set_as_root();
         root_node.set_state(s);
         root_node.set_action_space(model.get_action_space(s));
-        root_node.shuffle_action_space();
+        order_actions(root_node,s);
         expd_counter = 0;
-        for(unsigned i=0; i<budget; ++i) {
-            environment cp = model.get_copy();
-            node *ptr = tree_policy(root_node,cp);
-            double total_return = default_policy(ptr,cp);
-            backup(total_return,ptr);
-            ++expd_counter;
+        nb_records = 1 + root_node.get_nb_of_actions();
+        is_tree_full = false;
+        halving_arms.clear();
+        if(is_halving) {
+            sequential_halving();
+        } else {
+            iterate(budget);
         }
+        ++nb_searches;
+        nb_iterations_spent += expd_counter;
     }
 
     /**
@@ -273,22 +546,95 @@ public:
         return argmax(values);
     }
 
+    /**
+     * @brief Are halving arms valid
+     *
+     * @return Return true if there are remaining arms of a sequential halving, all of them
+     * being children of the root.
+     */
+    bool are_halving_arms_valid() const {
+        return !halving_arms.empty() && std::all_of(halving_arms.begin(),halving_arms.end(),[&](unsigned i) {
+            return i < root_node.children.size();
+        });
+    }
+
     /**
      * @brief Get the recommended action at a certain node
      *
      * This is the policy decision after the tree construction (recommended action).
      * Get the greedy action wrt the values of the subsequent nodes.
      * The indice of the selected action given as argument is modified consequently.
+     * At the root, the action is chosen among the children remaining in the sequential
+     * halving if any; the arms are ignored if they do not fit the children, e.g. if they
+     * belong to a previous root.
      * @param {const node &} v; root node of the tree
      * @param {unsigned &} indice; indice of the selected action
      * @return Return the action with the highest score (leading to the child node with the
      * higher value).
      */
     std::shared_ptr<action> get_recommended_action(const node &v, unsigned &indice) {
-        indice = argmax_score(v);
+        if(&v == &root_node && are_halving_arms_valid()) { // among the remaining children of the sequential halving
+            indice = halving_arms[argmax_of(halving_arms.size(),[&](unsigned i) {
+                return v.children[halving_arms[i]].get_value();
+            })];
+        } else {
+            indice = argmax_score(v);
+        }
         return v.get_action_at(indice);
     }
 
+    /**
+     * @brief Stop search
+     *
+     * Request the end of the current search, which then returns its current best action.
+     * May be called from any thread.
+     */
+    void stop_search() {
+        time_limit.stop();
+    }
+
+    /**
+     * @brief Clear stop
+     *
+     * Clear the request of 'stop_search', before a new search.
+     */
+    void clear_stop() {
+        time_limit.clear_stop();
+    }
+
+    /**
+     * @brief Search
+     *
+     * Build the tree at the given state and recommend an action, without updating the
+     * model, see 'mcts::search'.
+     * @param {const state &} s; state of the agent
+     * @return Return the recommended action at s.
+     */
+    std::shared_ptr<action> search(const state &s) {
+        build_oluct_tree(s);
+        unsigned indice = 0;
+        return get_recommended_action(root_node,indice);
+    }
+
+    /**
+     * @brief Update model
+     *
+     * Go to the next state of the model once the action recommended at the given state is
+     * undertaken.
+     * @param {const state &} s; current state of the agent
+     */
+    void update_model(const state &s) {
+        model.step(s);
+    }
+
+    /**
+     * @brief Discard search
+     *
+     * Drop the last search, whose state was not reached; nothing to do since the tree is
+     * rebuilt at each decision.
+     */
+    void discard_search() {}
+
     /**
      * @brief OLUCT policy operator
      *
@@ -297,10 +643,9 @@ public:
      * @return Return the undertaken action at s.
      */
 	std::shared_ptr<action> operator()(const state &s) {
-        build_oluct_tree(s);
-        model.step(s); // update the model
-        unsigned indice = 0;
-        return get_recommended_action(root_node,indice);
+        std::shared_ptr<action> a = search(s);
+        update_model(s);
+        return a;
 	}
 
     /**
@@ -324,11 +669,12 @@ public:
     /**
      * @brief Get backup
      *
-     * Get the backed-up values.
+     * Get the backed-up values, in the columns of 'mcts::get_backup'.
      * @return Return a vector containing the values to be saved.
      */
     std::vector<double> get_backup() {
-        return std::vector<double>{(double)nb_calls};
+        double iterations_per_decision = (nb_searches == 0) ? 0. : nb_iterations_spent / ((double) nb_searches);
+        return std::vector<double>{(double)nb_calls,0.,0.,iterations_per_decision}; // no tree reuse nor rollout memo
     }
 };
 
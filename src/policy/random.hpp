@@ -8,6 +8,7 @@
  */
 class random_policy {
 public:
+    static constexpr bool is_deterministic = false; ///< The action is drawn at random
     environment model; ///< Environment, used for action space reduction
 
     /**
@@ -24,13 +25,78 @@ public:
      * @brief Policy operator
      *
      * Policy operator for the undertaken action at given state.
+     * The action is drawn uniformly among the valid actions by reservoir sampling, so that
+     * no action space is built.
      * @param {const state &} s; given state
-     * @return Return the undertaken action at s.
+     * @return Return a reference to the undertaken action at s, valid as long as the policy.
      */
-	std::shared_ptr<action> operator()(const state &s) {
-        return rand_element(model.get_action_space(s));
+	const std::shared_ptr<action> &operator()(const state &s) {
+        const std::shared_ptr<action> *choice = nullptr;
+        unsigned nb_valid = 0;
+        for(auto &a : model.action_space) {
+            if(model.is_action_valid(s,a) && rand_unsigned() % ++nb_valid == 0) {
+                choice = &a;
+            }
+        }
+        if(choice == nullptr) { // Every action leads to a crash
+            return model.action_space[rand_indice(model.action_space)];
+        }
+        return *choice;
 	}
 
+    /**
+     * @brief Get speed bound
+     *
+     * Speed bound of the actions of the policy, see 'action::get_speed_bound'.
+     * @return Return the speed bound.
+     */
+    double get_speed_bound() const {
+        return model.get_speed_bound();
+    }
+
+    /**
+     * @brief Search
+     *
+     * Same as the policy operator, the model of the policy only being used for the
+     * validity of the actions.
+     * @param {const state &} s; state of the agent
+     * @return Return the undertaken action at s.
+     */
+    std::shared_ptr<action> search(const state &s) {
+        return (*this)(s);
+    }
+
+    /**
+     * @brief Update model
+     *
+     * Nothing to do, see 'search'.
+     * @param {const state &} s; current state of the agent
+     */
+    void update_model(const state &s) {
+        (void) s;
+    }
+
+    /**
+     * @brief Discard search
+     *
+     * Nothing to do, the policy keeps no search.
+     */
+    void discard_search() {}
+
+    /**
+     * @brief Stop search
+     *
+     * Nothing to do, the policy does not search.
+     */
+    void stop_search() {}
+
+    /**
+     * @brief Clear stop
+     *
+     * Nothing to do, the policy does not search.
+     */
+    void clear_stop() {}
+
     /**
      * @brief Process reward
      *
@@ -0,0 +1,537 @@
+#ifndef ROLLOUT_BATCH_HPP_
+#define ROLLOUT_BATCH_HPP_
+
+#include <variant>
+#include <vector>
+
+#include <rollout_engine.hpp>
+
+/**
+ * @brief Rollout request
+ *
+ * Rollout to be run by a 'rollout_batch'.
+ */
+template <class MD>
+class rollout_request {
+public:
+    state s; ///< Starting state
+    const std::shared_ptr<action> *a0; ///< First action
+    MD *mod; ///< Model of the rollout, must not be shared between requests if dynamic
+    double value = 0.; ///< Discounted return, set by the batch
+};
+
+/**
+ * @brief Rollout batch
+ *
+ * Simulation of several rollouts of a 'rollout_engine' in lockstep, for the noise-free
+ * models.
+ * The lanes are stored as arrays of NB_LANES doubles, the tests included, so that the
+ * kinematics of the actions (see 'action_kinematics'), the wall tests and the waypoint tests
+ * are loops of constant trip count over contiguous data, without branches: the selections
+ * only choose between values already computed, and the masks are 0 or 1 doubles, which
+ * lets the compiler vectorize the loops at -O2. The direction of the states is carried as
+ * a (cos,sin) pair rotated by the actions, so that no trigonometric function is evaluated
+ * along the rollouts.
+ * The rollouts that are done keep being simulated until the whole batch is done, and are
+ * masked out of the returns.
+ * The policy is still queried per lane, as are the reward models other than the waypoints
+ * and the walls other than the rectangles and the circles.
+ * The waypoints of the models are represented by masks over the waypoints of a base model,
+ * their superset, hence the models of the requests are not updated by the batch.
+ * The returns are those of 'rollout_engine::run' up to rounding, since the directions are
+ * rotated rather than computed from the angles.
+ */
+class rollout_batch {
+public:
+    static constexpr unsigned NB_LANES = 8; ///< Number of rollouts simulated in lockstep
+    static constexpr unsigned MAX_NB_WAYPOINTS = 32; ///< Number of waypoints above which their rewards are computed per lane
+
+    alignas(64) double x[NB_LANES]; ///< x coordinates
+    alignas(64) double y[NB_LANES]; ///< y coordinates
+    alignas(64) double v[NB_LANES]; ///< Velocities
+    alignas(64) double theta[NB_LANES]; ///< Angles
+    alignas(64) double c[NB_LANES]; ///< Cosines of the angles
+    alignas(64) double s[NB_LANES]; ///< Sines of the angles
+    alignas(64) double fv[NB_LANES]; ///< Velocity factors of the actions
+    alignas(64) double vmin[NB_LANES]; ///< Minimum velocities of the actions
+    alignas(64) double vmax[NB_LANES]; ///< Maximum velocities of the actions
+    alignas(64) double keep[NB_LANES]; ///< Heading kept by the actions, 0 or 1
+    alignas(64) double dtheta[NB_LANES]; ///< Angle variations of the actions
+    alignas(64) double cos_dtheta[NB_LANES]; ///< Cosines of the angle variations
+    alignas(64) double sin_dtheta[NB_LANES]; ///< Sines of the angle variations
+    alignas(64) double dx[NB_LANES]; ///< x variations of the actions
+    alignas(64) double dy[NB_LANES]; ///< y variations of the actions
+    alignas(64) double is_in_wall[NB_LANES]; ///< Wall tests of the states, 0 or 1
+    alignas(64) double was_in_wall[NB_LANES]; ///< Wall tests of the states before the step, 0 or 1
+    alignas(64) double is_wp_reached[NB_LANES]; ///< Waypoint tests of the states, 0 or 1
+    alignas(64) double nb_wp[NB_LANES]; ///< Numbers of remaining waypoints
+    alignas(64) double wp_mask[MAX_NB_WAYPOINTS][NB_LANES]; ///< Remaining base waypoints of the lanes, 0 or 1
+    alignas(64) double reward[NB_LANES]; ///< Rewards of the step
+    alignas(64) double discount[NB_LANES]; ///< Discounts of the step, 0 for the rollouts that are done
+    alignas(64) double total_return[NB_LANES]; ///< Discounted returns
+    unsigned t[NB_LANES]; ///< Times
+    double speed_bound[NB_LANES]; ///< Speed bounds of the rollouts
+    const std::shared_ptr<action> *a[NB_LANES]; ///< Actions of the step
+    int kinematics_index[NB_LANES]; ///< Indices of the kinematics of the actions, -1 if none
+
+    std::vector<const action *> kinematics_actions; ///< Actions whose kinematics are tabulated
+    std::vector<action_kinematics> kinematics; ///< Tabulated kinematics
+    std::vector<double> rect_x, rect_y, rect_hw, rect_hh; ///< Rectangle walls: centers, half widths and half heights minus the comparison threshold
+    std::vector<double> circle_x, circle_y, circle_r2; ///< Circle walls: centers, squared radii minus the comparison threshold
+    std::vector<const shape *> other_walls; ///< Walls tested per lane
+    std::vector<double> wp_x, wp_y, wp_r2, wp_r; ///< Base waypoints: centers, squared radii minus the comparison threshold and radii
+    const std::vector<circle> *base_wp_list = nullptr; ///< Waypoints of the base model, possibly shared by the lanes
+
+    /**
+     * @brief Is supported
+     *
+     * Test whether the rollouts of the given model may be simulated in lockstep.
+     * @param {const MD &} mod; model
+     * @return Return true if the model is noise-free.
+     */
+    template <class MD>
+    static bool is_supported(const MD &mod) {
+        return !(mod.misstep_probability > 0.) && !(mod.state_gaussian_stddev > 0.);
+    }
+
+    /**
+     * @brief Run
+     *
+     * Run the given rollouts, by batches of NB_LANES, and set their returns; the rollouts
+     * of a model that is not supported, see 'is_supported', are run one by one with the
+     * engine.
+     * @param {const rollout_engine &} engine; rollout engine
+     * @param {const MD &} base; base model, whose walls are those of the models of the
+     * requests and whose waypoints, if any, are a superset of theirs
+     * @param {std::vector<rollout_request<MD>> &} requests; rollouts
+     * @param {PL &} policy; policy functor giving a reference to the action at a state
+     * @param {unsigned &} nb_steps; number of simulated steps, incremented
+     */
+    template <class MD, class PL>
+    void run(
+        const rollout_engine &engine,
+        const MD &base,
+        std::vector<rollout_request<MD>> &requests,
+        PL &policy,
+        unsigned &nb_steps)
+    {
+        if(!is_supported(base)) {
+            for(auto &rq : requests) {
+                rq.value = engine.run(rq.s,*rq.a0,*rq.mod,policy,nb_steps);
+            }
+            return;
+        }
+        kinematics_actions.clear(); // the actions may not outlive the call
+        kinematics.clear();
+        set_walls(base);
+        const waypoints *base_wp = std::get_if<waypoints>(&base.rmodel.model);
+        if(base_wp != nullptr && base_wp->wp->size() <= MAX_NB_WAYPOINTS) {
+            set_waypoints(*base_wp);
+        } else {
+            base_wp = nullptr;
+        }
+        for(unsigned first=0; first<requests.size(); first+=NB_LANES) {
+            unsigned n = std::min(NB_LANES,(unsigned) requests.size() - first);
+            rollout_request<MD> *rq = requests.data() + first;
+            bool is_masked = (base_wp != nullptr);
+            for(unsigned l=0; l<n && is_masked; ++l) {
+                is_masked = set_mask(l,std::get_if<waypoints>(&rq[l].mod->rmodel.model));
+            }
+            if(is_masked) {
+                run_lanes<true>(engine,base,rq,n,policy,nb_steps);
+            } else {
+                run_lanes<false>(engine,base,rq,n,policy,nb_steps);
+            }
+        }
+    }
+
+    /**
+     * @brief Set walls
+     *
+     * Tabulate the rectangle and circle walls of the given model.
+     * @param {const MD &} mod; model
+     */
+    template <class MD>
+    void set_walls(const MD &mod) {
+        rect_x.clear(); rect_y.clear(); rect_hw.clear(); rect_hh.clear();
+        circle_x.clear(); circle_y.clear(); circle_r2.clear();
+        other_walls.clear();
+        for(auto &w : mod.walls) {
+            if(const rectangle *r = dynamic_cast<const rectangle *>(&w)) {
+                rect_x.push_back(std::get<0>(r->center));
+                rect_y.push_back(std::get<1>(r->center));
+                rect_hw.push_back(r->width / 2. - COMPARISON_THRESHOLD);
+                rect_hh.push_back(r->height / 2. - COMPARISON_THRESHOLD);
+            } else if(const circle *ci = dynamic_cast<const circle *>(&w)) {
+                circle_x.push_back(std::get<0>(ci->center));
+                circle_y.push_back(std::get<1>(ci->center));
+                circle_r2.push_back(ci->radius * ci->radius - COMPARISON_THRESHOLD);
+            } else {
+                other_walls.push_back(&w);
+            }
+        }
+    }
+
+    /**
+     * @brief Set waypoints
+     *
+     * Tabulate the base waypoints.
+     * @param {const waypoints &} m; base waypoints model
+     */
+    void set_waypoints(const waypoints &m) {
+        wp_x.clear(); wp_y.clear(); wp_r2.clear(); wp_r.clear();
+        base_wp_list = m.wp.get();
+        for(auto &w : *m.wp) {
+            wp_x.push_back(std::get<0>(w.center));
+            wp_y.push_back(std::get<1>(w.center));
+            wp_r2.push_back(w.radius * w.radius - COMPARISON_THRESHOLD);
+            wp_r.push_back(w.radius);
+        }
+    }
+
+    /**
+     * @brief Set mask
+     *
+     * Set the mask of the waypoints of the given lane, every base waypoint being kept if
+     * the lane shares the waypoints of the base model.
+     * @param {unsigned} l; lane
+     * @param {const waypoints *} m; waypoints model of the lane, if any
+     * @return Return false if some waypoint of the lane is not a base waypoint.
+     */
+    bool set_mask(unsigned l, const waypoints *m) {
+        if(m == nullptr) {
+            return false;
+        }
+        bool is_shared = (m->wp.get() == base_wp_list);
+        for(unsigned j=0; j<wp_x.size(); ++j) {
+            wp_mask[j][l] = is_shared ? 1. : 0.;
+        }
+        if(is_shared) {
+            return true;
+        }
+        for(auto &w : *m->wp) {
+            unsigned j = 0;
+            while(j < wp_x.size() && !(
+                std::get<0>(w.center) == wp_x[j]
+                && std::get<1>(w.center) == wp_y[j]
+                && w.radius == wp_r[j])) {
+                ++j;
+            }
+            if(j == wp_x.size()) {
+                return false;
+            }
+            wp_mask[j][l] = 1.;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Set action
+     *
+     * Set the action of the given lane and its kinematics.
+     * @param {unsigned} l; lane
+     * @param {const std::shared_ptr<action> &} act; action
+     */
+    void set_action(unsigned l, const std::shared_ptr<action> &act) {
+        a[l] = &act;
+        const action *p = act.get();
+        if(kinematics_index[l] >= 0 && kinematics_actions[kinematics_index[l]] == p) { // same action
+            return;
+        }
+        int k = 0;
+        while(k < (int) kinematics_actions.size() && kinematics_actions[k] != p) {
+            ++k;
+        }
+        if(k == (int) kinematics_actions.size()) { // new action
+            action_kinematics kin;
+            if(!p->get_kinematics(kin)) {
+                kinematics_index[l] = -1;
+                kin = {1.,std::numeric_limits<double>::lowest(),std::numeric_limits<double>::max(),1.,0.,1.,0.,0.,0.};
+                load_kinematics(l,kin);
+                return;
+            }
+            kinematics_actions.push_back(p);
+            kinematics.push_back(kin);
+        }
+        kinematics_index[l] = k;
+        load_kinematics(l,kinematics[k]);
+    }
+
+    /**
+     * @brief Load kinematics
+     *
+     * @param {unsigned} l; lane
+     * @param {const action_kinematics &} k; kinematics of the action of the lane
+     */
+    void load_kinematics(unsigned l, const action_kinematics &k) {
+        fv[l] = k.fv;
+        vmin[l] = k.vmin;
+        vmax[l] = k.vmax;
+        keep[l] = k.keep;
+        dtheta[l] = k.dtheta;
+        cos_dtheta[l] = k.cos_dtheta;
+        sin_dtheta[l] = k.sin_dtheta;
+        dx[l] = k.dx;
+        dy[l] = k.dy;
+    }
+
+    /**
+     * @brief Get state
+     *
+     * @param {unsigned} l; lane
+     * @param {unsigned} wrc; waypoints reached counter of the lane
+     * @return Return the state of the given lane.
+     */
+    state get_state(unsigned l, unsigned wrc) const {
+        return state(t[l],x[l],y[l],v[l],theta[l],wrc);
+    }
+
+    /**
+     * @brief Apply actions
+     *
+     * Apply the kinematics of the actions to every lane, see 'action_kinematics', and
+     * bounce the lanes within a wall, as 'environment::state_transition'.
+     * @param {double} xsize; horizontal dimension of the environment
+     * @param {double} ysize; vertical dimension of the environment
+     * @param {bool} is_crash_terminal; are the crashes terminal
+     */
+    void apply_actions(double xsize, double ysize, bool is_crash_terminal) {
+        for(unsigned l=0; l<NB_LANES; ++l) { // the blends by keep, 0 or 1, are exact
+            double k = keep[l];
+            double vv = v[l] * fv[l];
+            vv = (vv > vmax[l] + COMPARISON_THRESHOLD) ? vmax[l] : vv;
+            vv = (vv < vmin[l] - COMPARISON_THRESHOLD) ? vmin[l] : vv;
+            double cr = c[l] * cos_dtheta[l] - s[l] * sin_dtheta[l];
+            double sr = s[l] * cos_dtheta[l] + c[l] * sin_dtheta[l];
+            v[l] = k * vv + (1. - k) * vmax[l];
+            c[l] = k * cr + (1. - k) * cos_dtheta[l];
+            s[l] = k * sr + (1. - k) * sin_dtheta[l];
+            theta[l] = k * theta[l] + dtheta[l];
+            x[l] += k * v[l] * c[l] + (1. - k) * dx[l];
+            y[l] += k * v[l] * s[l] + (1. - k) * dy[l];
+        }
+        test_walls(xsize,ysize);
+        double flip = is_crash_terminal ? 0. : 1.;
+        for(unsigned l=0; l<NB_LANES; ++l) { // bounce and angle modulus
+            double b = is_in_wall[l] * flip;
+            double f = 1. - 2. * b;
+            c[l] *= f;
+            s[l] *= f;
+            double th = theta[l] + b * M_PI;
+            double up = (th < -M_PI - COMPARISON_THRESHOLD) ? 2. * M_PI : 0.;
+            double down = (th > M_PI + COMPARISON_THRESHOLD) ? 2. * M_PI : 0.;
+            theta[l] = th + up - down;
+        }
+    }
+
+    /**
+     * @brief Test walls
+     *
+     * Set the wall tests of the lanes, as 'environment::is_wall_encountered_at'.
+     * @param {double} xsize; horizontal dimension of the environment
+     * @param {double} ysize; vertical dimension of the environment
+     */
+    void test_walls(double xsize, double ysize) {
+        for(unsigned l=0; l<NB_LANES; ++l) {
+            double h = (x[l] < -COMPARISON_THRESHOLD) ? 1. : 0.;
+            h = (y[l] < -COMPARISON_THRESHOLD) ? 1. : h;
+            h = (x[l] > xsize + COMPARISON_THRESHOLD) ? 1. : h;
+            h = (y[l] > ysize + COMPARISON_THRESHOLD) ? 1. : h;
+            is_in_wall[l] = h;
+        }
+        for(unsigned j=0; j<rect_x.size(); ++j) {
+            double cx = rect_x[j], cy = rect_y[j], hw = rect_hw[j], hh = rect_hh[j];
+            for(unsigned l=0; l<NB_LANES; ++l) { // a < b iff a - b < 0
+                double ex = fabs(x[l] - cx) - hw;
+                double ey = fabs(y[l] - cy) - hh;
+                double e = (ex > ey) ? ex : ey;
+                is_in_wall[l] = (e < 0.) ? 1. : is_in_wall[l];
+            }
+        }
+        for(unsigned j=0; j<circle_x.size(); ++j) {
+            double cx = circle_x[j], cy = circle_y[j], r2 = circle_r2[j];
+            for(unsigned l=0; l<NB_LANES; ++l) {
+                double ddx = x[l] - cx, ddy = y[l] - cy;
+                is_in_wall[l] = (ddx * ddx + ddy * ddy < r2) ? 1. : is_in_wall[l];
+            }
+        }
+        for(auto w : other_walls) {
+            for(unsigned l=0; l<NB_LANES; ++l) {
+                if(w->is_within(x[l],y[l])) {
+                    is_in_wall[l] = 1.;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Test waypoints
+     *
+     * Set the waypoint tests of the lanes wrt their remaining waypoints and, if requested,
+     * remove the reached waypoints from the masks.
+     * @param {bool} is_removed; remove the reached waypoints
+     */
+    void test_waypoints(bool is_removed) {
+        double removal = is_removed ? 1. : 0.;
+        for(unsigned l=0; l<NB_LANES; ++l) {
+            is_wp_reached[l] = 0.;
+            nb_wp[l] = 0.;
+        }
+        for(unsigned j=0; j<wp_x.size(); ++j) {
+            double cx = wp_x[j], cy = wp_y[j], r2 = wp_r2[j];
+            for(unsigned l=0; l<NB_LANES; ++l) {
+                double ddx = x[l] - cx, ddy = y[l] - cy;
+                double hit = ((ddx * ddx + ddy * ddy < r2) ? 1. : 0.) * wp_mask[j][l];
+                is_wp_reached[l] = (hit > 0.) ? 1. : is_wp_reached[l];
+                wp_mask[j][l] -= removal * hit;
+                nb_wp[l] += wp_mask[j][l];
+            }
+        }
+    }
+
+    /**
+     * @brief Get maximum reward within
+     *
+     * Same as 'waypoints::get_max_reward_within' for the remaining waypoints of a lane.
+     * @param {unsigned} l; lane
+     * @param {double} reach; distance to the state of the lane
+     * @param {double} wp_value; reward when reaching a waypoint
+     * @return Return the bound.
+     */
+    double get_max_reward_within(unsigned l, double reach, double wp_value) const {
+        for(unsigned j=0; j<wp_x.size(); ++j) {
+            if(wp_mask[j][l] > 0. && hypot(wp_x[j] - x[l], wp_y[j] - y[l]) <= wp_r[j] + reach) {
+                return fabs(wp_value);
+            }
+        }
+        return 0.;
+    }
+
+    /**
+     * @brief Run lanes
+     *
+     * Run the n given rollouts in lockstep, the steps being those of 'rollout_engine::run'.
+     * @param {const rollout_engine &} engine; rollout engine
+     * @param {const MD &} base; base model
+     * @param {rollout_request<MD> *} rq; rollouts
+     * @param {unsigned} n; number of rollouts, at most NB_LANES
+     * @param {PL &} policy; policy functor giving a reference to the action at a state
+     * @param {unsigned &} nb_steps; number of simulated steps, incremented
+     */
+    template <bool IS_MASKED, class MD, class PL>
+    void run_lanes(
+        const rollout_engine &engine,
+        const MD &base,
+        rollout_request<MD> *rq,
+        unsigned n,
+        PL &policy,
+        unsigned &nb_steps)
+    {
+        const double wp_value = IS_MASKED ? std::get<waypoints>(base.rmodel.model).wp_value : 0.;
+        unsigned wrc[NB_LANES];
+        for(unsigned l=0; l<NB_LANES; ++l) {
+            unsigned i = (l < n) ? l : 0; // idle lanes replicate the first one
+            const state &s0 = rq[i].s;
+            t[l] = s0.t;
+            x[l] = s0.x;
+            y[l] = s0.y;
+            v[l] = s0.v;
+            theta[l] = s0.theta;
+            c[l] = cos(s0.theta);
+            s[l] = sin(s0.theta);
+            wrc[l] = s0.waypoints_reached_counter;
+            for(unsigned j=0; j<wp_x.size(); ++j) {
+                wp_mask[j][l] = wp_mask[j][i];
+            }
+            discount[l] = (l < n) ? 1. : 0.;
+            total_return[l] = 0.;
+            is_in_wall[l] = rq[i].mod->is_wall_encountered_at(s0);
+            speed_bound[l] = (engine.truncation_epsilon > 0.) ? engine.get_speed_bound(s0,*rq[i].a0,*rq[i].mod,policy) : 0.;
+            kinematics_index[l] = -1;
+            set_action(l,*rq[i].a0);
+        }
+        unsigned nb_active = n;
+        for(unsigned step=0; step<engine.horizon && nb_active > 0; ++step) {
+            state prev[NB_LANES];
+            for(unsigned l=0; l<NB_LANES; ++l) {
+                was_in_wall[l] = is_in_wall[l];
+            }
+            for(unsigned l=0; l<NB_LANES; ++l) {
+                if(!IS_MASKED || kinematics_index[l] < 0) {
+                    prev[l] = get_state(l,wrc[l]);
+                }
+            }
+            if(IS_MASKED) { // reward of the state before the step
+                test_waypoints(false);
+            }
+            apply_actions(base.xsize,base.ysize,base.is_crash_terminal);
+            for(unsigned l=0; l<NB_LANES; ++l) {
+                if(kinematics_index[l] < 0 && discount[l] > 0.) { // action without kinematics
+                    state s_p = prev[l];
+                    bool is_valid = rq[l].mod->state_transition(prev[l],*a[l],s_p);
+                    t[l] = s_p.t; x[l] = s_p.x; y[l] = s_p.y; v[l] = s_p.v; theta[l] = s_p.theta;
+                    c[l] = cos(s_p.theta);
+                    s[l] = sin(s_p.theta);
+                    is_in_wall[l] = is_valid ? 0. : 1.;
+                } else {
+                    ++t[l];
+                }
+            }
+            if(IS_MASKED) {
+                for(unsigned l=0; l<NB_LANES; ++l) {
+                    double r = is_wp_reached[l] * wp_value;
+                    reward[l] = (was_in_wall[l] > 0.) ? base.wall_reward : r;
+                }
+            } else {
+                for(unsigned l=0; l<NB_LANES; ++l) {
+                    reward[l] = 0.;
+                    if(discount[l] > 0.) {
+                        reward[l] = (was_in_wall[l] > 0.) ? base.wall_reward : rq[l].mod->rmodel.get_reward_value_at(prev[l],*a[l],get_state(l,wrc[l]));
+                    }
+                }
+            }
+            for(unsigned l=0; l<NB_LANES; ++l) {
+                total_return[l] += discount[l] * reward[l];
+            }
+            nb_steps += nb_active;
+            if(IS_MASKED) {
+                test_waypoints(engine.is_model_dynamic);
+            }
+            unsigned nb_remaining = engine.horizon - step - 1;
+            double reach = (nb_remaining > 1) ? nb_remaining - 1 : 0.;
+            for(unsigned l=0; l<n; ++l) {
+                if(discount[l] == 0.) {
+                    continue;
+                }
+                discount[l] *= engine.discount_factor;
+                bool is_done;
+                if(IS_MASKED) {
+                    is_done = (is_in_wall[l] > 0. && base.is_crash_terminal) || nb_wp[l] == 0. || get_state(l,wrc[l]).is_terminal();
+                } else {
+                    state s_p = get_state(l,wrc[l]);
+                    if(engine.is_model_dynamic) {
+                        rq[l].mod->step(s_p);
+                    }
+                    is_done = rq[l].mod->is_terminal(s_p,is_in_wall[l] > 0.);
+                }
+                if(!is_done && engine.truncation_epsilon > 0.) {
+                    double bound = IS_MASKED
+                        ? std::max(fabs(base.wall_reward),get_max_reward_within(l,speed_bound[l] * reach,wp_value))
+                        : rq[l].mod->get_max_reward_within(get_state(l,wrc[l]),speed_bound[l] * reach);
+                    is_done = discount[l] * engine.tail_weights[nb_remaining] * bound < engine.truncation_epsilon;
+                }
+                if(is_done) {
+                    discount[l] = 0.;
+                    --nb_active;
+                } else if(nb_remaining > 0) {
+                    set_action(l,policy(get_state(l,wrc[l])));
+                }
+            }
+        }
+        for(unsigned l=0; l<n; ++l) {
+            rq[l].value = total_return[l];
+        }
+    }
+};
+
+#endif // ROLLOUT_BATCH_HPP_
@@ -0,0 +1,142 @@
+#ifndef ROLLOUT_ENGINE_HPP_
+#define ROLLOUT_ENGINE_HPP_
+
+#include <environment.hpp>
+
+/**
+ * @brief Rollout engine
+ *
+ * Simulation of a default policy over a finite horizon, used by the tree-search policies to
+ * evaluate their leaves.
+ * The discount is applied incrementally and every step fuses the state transition, the
+ * reward and the termination criterion so that the position of each reached state is
+ * tested against the walls once (see 'environment::rollout_transition').
+ * A rollout does not allocate, provided that the policy does not, and the actions are not
+ * copied: the policy returns a reference to an action it holds, which avoids the atomic
+ * reference counting of the shared pointers at every step, a contention point between
+ * the search threads that all point to the same actions.
+ * A rollout may be truncated as soon as the discounted return it may still collect is
+ * provably below a given epsilon: the speed bound of the actions bounds the region that
+ * the remaining steps may reach, and the reward model bounds the reward within it, which is
+ * zero e.g. out of the reach of the remaining waypoints.
+ * The spatial bound is not used with a Gaussian noise on the state, which is unbounded.
+ */
+class rollout_engine {
+public:
+    double discount_factor; ///< MDP discount factor
+    unsigned horizon; ///< Maximum number of steps of a rollout
+    bool is_model_dynamic; ///< Is the model updated along the rollouts
+    double truncation_epsilon; ///< Bound of the remaining return below which a rollout stops, 0 to disable
+    std::vector<double> tail_weights; ///< Sum of the discounts of the k first steps, for k in [0,horizon]
+
+    /**
+     * @brief Constructor
+     *
+     * @param {double} _discount_factor; MDP discount factor
+     * @param {unsigned} _horizon; maximum number of steps of a rollout
+     * @param {bool} _is_model_dynamic; is the model updated along the rollouts
+     * @param {double} _truncation_epsilon; bound of the remaining return below which a
+     * rollout stops, 0 to disable
+     */
+    rollout_engine(
+        double _discount_factor = 1.,
+        unsigned _horizon = 0,
+        bool _is_model_dynamic = false,
+        double _truncation_epsilon = 0.) :
+        discount_factor(_discount_factor),
+        horizon(_horizon),
+        is_model_dynamic(_is_model_dynamic),
+        truncation_epsilon(_truncation_epsilon)
+    {
+        tail_weights.reserve(horizon + 1);
+        tail_weights.push_back(0.);
+        double discount = 1.;
+        for(unsigned k=0; k<horizon; ++k) {
+            tail_weights.push_back(tail_weights.back() + discount);
+            discount *= discount_factor;
+        }
+    }
+
+    /**
+     * @brief Get speed bound
+     *
+     * Bound of the velocity and of the displacement at every step of a rollout starting
+     * with the given state and action, see 'action::get_speed_bound'; the missteps draw
+     * actions from the model.
+     * @param {const state &} s; starting state
+     * @param {const std::shared_ptr<action> &} a0; first action
+     * @param {const MD &} mod; model
+     * @param {const PL &} policy; policy
+     * @return Return the speed bound, infinite if the state is subject to a Gaussian noise.
+     */
+    template <class MD, class PL>
+    static double get_speed_bound(
+        const state &s,
+        const std::shared_ptr<action> &a0,
+        const MD &mod,
+        const PL &policy)
+    {
+        if(mod.state_gaussian_stddev > 0.) {
+            return std::numeric_limits<double>::infinity();
+        }
+        double bound = std::max({fabs(s.v),a0->get_speed_bound(),policy.get_speed_bound()});
+        if(mod.misstep_probability > 0.) {
+            bound = std::max(bound,mod.get_speed_bound());
+        }
+        return bound;
+    }
+
+    /**
+     * @brief Run
+     *
+     * Run the policy from the given state and action and compute the discounted return.
+     * The rollout stops at the horizon, at the first terminal state, which is tested after
+     * the update of the model, or once truncated.
+     * @param {state} s; starting state
+     * @param {const std::shared_ptr<action> &} a0; first action
+     * @param {MD &} mod; model, updated along the rollout if dynamic
+     * @param {PL &} policy; policy functor giving a reference to the action at a state
+     * @param {unsigned &} nb_steps; number of simulated steps, incremented
+     * @return Return the discounted return.
+     */
+    template <class MD, class PL>
+    double run(
+        state s,
+        const std::shared_ptr<action> &a0,
+        MD &mod,
+        PL &policy,
+        unsigned &nb_steps) const
+    {
+        double total_return = 0.;
+        double discount = 1.;
+        bool is_in_wall = mod.is_wall_encountered_at(s);
+        const std::shared_ptr<action> *a = &a0;
+        state s_p;
+        double speed_bound = (truncation_epsilon > 0.) ? get_speed_bound(s,a0,mod,policy) : 0.;
+        for(unsigned t=0; t<horizon; ++t) {
+            double r;
+            mod.rollout_transition(s,is_in_wall,*a,r,s_p);
+            ++nb_steps;
+            total_return += discount * r;
+            discount *= discount_factor;
+            if(is_model_dynamic) {
+                mod.step(s_p);
+            }
+            if(mod.is_terminal(s_p,is_in_wall)) {
+                break;
+            }
+            if(truncation_epsilon > 0.) { // the k-th remaining reward is collected within (k-1) steps of s_p
+                unsigned nb_remaining = horizon - t - 1;
+                double reach = (nb_remaining > 1) ? speed_bound * (nb_remaining - 1) : 0.;
+                if(discount * tail_weights[nb_remaining] * mod.get_max_reward_within(s_p,reach) < truncation_epsilon) {
+                    break;
+                }
+            }
+            s = s_p;
+            a = &policy(s);
+        }
+        return total_return;
+    }
+};
+
+#endif // ROLLOUT_ENGINE_HPP_
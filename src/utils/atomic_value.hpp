@@ -0,0 +1,100 @@
+#ifndef ATOMIC_VALUE_HPP_
+#define ATOMIC_VALUE_HPP_
+
+#include <atomic>
+#include <type_traits>
+
+/**
+ * @brief Atomic value
+ *
+ * Copyable wrapper of 'std::atomic', so that atomic counters and statistics can be stored
+ * in resizable containers and in copyable classes.
+ * Loads have acquire semantics and stores release semantics, hence a value published
+ * through an atomic value is visible to the threads reading it.
+ * Copies are not atomic as a whole and must not race with concurrent writes.
+ * Template class.
+ */
+template <class T>
+class atomic_value {
+public:
+    std::atomic<T> value; ///< Wrapped value
+
+    /**
+     * @brief Constructor
+     *
+     * @param {T} v; initial value
+     */
+    atomic_value(T v = T()) : value(v) {}
+
+    /** @brief Copy constructor */
+    atomic_value(const atomic_value &other) : value(other.load()) {}
+
+    /** @brief Copy assignment */
+    atomic_value &operator=(const atomic_value &other) {
+        store(other.load());
+        return *this;
+    }
+
+    /** @brief Assignment */
+    atomic_value &operator=(T v) {
+        store(v);
+        return *this;
+    }
+
+    /** @brief Load the value */
+    T load() const {
+        return value.load(std::memory_order_acquire);
+    }
+
+    /** @brief Store a value */
+    void store(T v) {
+        value.store(v,std::memory_order_release);
+    }
+
+    /** @brief Conversion to the wrapped type */
+    operator T() const {
+        return load();
+    }
+
+    /**
+     * @brief Fetch add
+     *
+     * Atomically add a value; floating point values are added with a compare-and-swap loop.
+     * @param {T} v; added value
+     * @return Return the value before the addition.
+     */
+    T fetch_add(T v) {
+        if constexpr (std::is_integral<T>::value) {
+            return value.fetch_add(v,std::memory_order_acq_rel);
+        } else {
+            T expected = value.load(std::memory_order_relaxed);
+            while(!value.compare_exchange_weak(expected,expected + v,std::memory_order_acq_rel)) {}
+            return expected;
+        }
+    }
+
+    /** @brief Atomic addition */
+    atomic_value &operator+=(T v) {
+        fetch_add(v);
+        return *this;
+    }
+
+    /** @brief Atomic pre-increment */
+    atomic_value &operator++() {
+        fetch_add(1);
+        return *this;
+    }
+
+    /** @brief Atomic post-increment */
+    T operator++(int) {
+        return fetch_add(1);
+    }
+
+    /** @brief Atomic pre-decrement, integral types only */
+    atomic_value &operator--() {
+        value.fetch_sub(1,std::memory_order_acq_rel);
+        return *this;
+    }
+};
+
+#endif // ATOMIC_VALUE_HPP_
@@ -0,0 +1,95 @@
+#ifndef DEADLINE_HPP_
+#define DEADLINE_HPP_
+
+#include <chrono>
+
+#include <atomic_value.hpp>
+
+/**
+ * @brief Deadline
+ *
+ * Time budget of a decision, measured on the monotonic clock so that it is not affected by
+ * the adjustments of the system time.
+ * A null duration disables the time budget.
+ * A stop may also be requested from another thread, e.g. by a control loop needing the
+ * action right away; the search then returns its current best action.
+ * The stop request is kept until 'clear_stop', not cleared by 'start', so that a stop
+ * requested before the search starts is not lost.
+ */
+class deadline {
+public:
+    typedef std::chrono::steady_clock clock; ///< Monotonic clock
+
+    double duration_ms; ///< Time budget in milliseconds, 0 if disabled
+    clock::time_point end; ///< Expiry date of the current decision
+    atomic_value<bool> is_stop_requested; ///< Set to true by 'stop'
+
+    /**
+     * @brief Constructor
+     *
+     * @param {double} _duration_ms; time budget in milliseconds, 0 to disable it
+     */
+    deadline(double _duration_ms = 0.) : duration_ms(_duration_ms), end(clock::now()), is_stop_requested(false) {}
+
+    /**
+     * @brief Start
+     *
+     * Start the time budget of a new decision.
+     */
+    void start() {
+        end = clock::now() + std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double,std::milli>(duration_ms)
+        );
+    }
+
+    /**
+     * @brief Share
+     *
+     * Restrict the time budget to an even share of its remaining time, e.g. to a round of a
+     * sequential halving, the rounds left getting the other shares; a disabled or expired
+     * time budget is left unchanged.
+     * @param {unsigned} nb_shares; number of shares of the remaining time
+     * @return Return the expiry date of the decision, to be restored into 'end' once the
+     * share is over.
+     */
+    clock::time_point share(unsigned nb_shares) {
+        clock::time_point decision_end = end;
+        clock::time_point now = clock::now();
+        if(duration_ms > 0. && nb_shares > 1 && now < end) {
+            end = now + (end - now) / nb_shares;
+        }
+        return decision_end;
+    }
+
+    /**
+     * @brief Stop
+     *
+     * Request the end of the current decision, may be called from any thread.
+     */
+    void stop() {
+        is_stop_requested = true;
+    }
+
+    /**
+     * @brief Clear stop
+     *
+     * Clear the stop request, before a new decision that may not be stopped by the
+     * previous request.
+     */
+    void clear_stop() {
+        is_stop_requested = false;
+    }
+
+    /**
+     * @brief Is expired
+     *
+     * Test whether the decision must end; this costs a read of the monotonic clock, which
+     * does not involve a system call on the usual platforms.
+     * @return Return true if a stop was requested or the time budget is over.
+     */
+    bool is_expired() const {
+        return is_stop_requested || (duration_ms > 0. && clock::now() >= end);
+    }
+};
+
+#endif // DEADLINE_HPP_
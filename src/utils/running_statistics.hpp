@@ -0,0 +1,137 @@
+#ifndef RUNNING_STATISTICS_HPP_
+#define RUNNING_STATISTICS_HPP_
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Welford update
+ *
+ * Update a running count, mean and sum of squared deviations (M2) with a new sample,
+ * following Welford's online algorithm.
+ * @param {unsigned &} count; number of samples
+ * @param {double &} mean; mean of the samples
+ * @param {double &} m2; sum of the squared deviations to the mean
+ * @param {double} x; new sample
+ */
+inline void welford_update(unsigned &count, double &mean, double &m2, double x) {
+    ++count;
+    double delta = x - mean;
+    mean += delta / ((double) count);
+    m2 += delta * (x - mean);
+}
+
+/**
+ * @brief Running statistics
+ *
+ * Constant memory estimator of the mean and variance of a stream of samples.
+ */
+class running_statistics {
+public:
+    unsigned count; ///< Number of samples
+    double mean; ///< Mean of the samples
+    double m2; ///< Sum of the squared deviations to the mean
+
+    /**
+     * @brief Constructor
+     */
+    running_statistics() : count(0), mean(0.), m2(0.) {}
+
+    /**
+     * @brief Add
+     *
+     * Add a sample to the statistics.
+     * @param {double} x; new sample
+     */
+    void add(double x) {
+        welford_update(count,mean,m2,x);
+    }
+
+    /**
+     * @brief Merge
+     *
+     * Merge the statistics of another set of samples (Chan et al. parallel algorithm).
+     * @param {unsigned} n; number of samples of the other set
+     * @param {double} n_mean; mean of the other set
+     * @param {double} n_m2; sum of the squared deviations of the other set
+     */
+    void merge(unsigned n, double n_mean, double n_m2) {
+        if(n == 0) {
+            return;
+        }
+        unsigned total = count + n;
+        double delta = n_mean - mean;
+        mean += delta * ((double) n) / ((double) total);
+        m2 += n_m2 + delta * delta * ((double) count) * ((double) n) / ((double) total);
+        count = total;
+    }
+
+    /** @brief Clear the statistics */
+    void clear() {
+        count = 0;
+        mean = 0.;
+        m2 = 0.;
+    }
+
+    /** @brief Get the number of samples */
+    unsigned get_count() const {
+        return count;
+    }
+
+    /** @brief Get the mean of the samples */
+    double get_mean() const {
+        return mean;
+    }
+
+    /** @brief Get the (population) variance of the samples, 0 if no sample */
+    double get_variance() const {
+        return (count == 0) ? 0. : m2 / ((double) count);
+    }
+};
+
+/**
+ * @brief Is best arm separated
+ *
+ * Confidence interval test on the means of a set of arms: the arm of maximum mean is
+ * separated if the lower bound mean - z * stddev / sqrt(n) of its mean is above the upper
+ * bound mean + z * stddev / sqrt(n) of the mean of every other arm.
+ * The bounds of an arm sampled less than twice are infinite.
+ * @param {unsigned} nb_arms; number of arms
+ * @param {double} z; confidence quantile
+ * @param {F} arm; function taking an arm indice and setting its number of samples, mean
+ * and variance given by reference, in this order
+ * @return Return true if the arm of maximum mean is separated.
+ */
+template <class F>
+inline bool is_best_arm_separated(unsigned nb_arms, double z, F arm) {
+    auto bound = [&](unsigned i, double sign) {
+        unsigned n;
+        double mean, variance;
+        arm(i,n,mean,variance);
+        if(n < 2) {
+            return sign * std::numeric_limits<double>::infinity();
+        }
+        return mean + sign * z * std::sqrt(variance / ((double) n));
+    };
+    unsigned best = 0;
+    double best_mean = -std::numeric_limits<double>::infinity();
+    for(unsigned i=0; i<nb_arms; ++i) {
+        unsigned n;
+        double mean, variance;
+        arm(i,n,mean,variance);
+        if(mean > best_mean) {
+            best = i;
+            best_mean = mean;
+        }
+    }
+    double lower = bound(best,-1.);
+    for(unsigned i=0; i<nb_arms; ++i) {
+        if(i != best && bound(i,1.) >= lower) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // RUNNING_STATISTICS_HPP_
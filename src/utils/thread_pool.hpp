@@ -0,0 +1,172 @@
+#ifndef THREAD_POOL_HPP_
+#define THREAD_POOL_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <utils.hpp>
+
+/**
+ * @brief Thread pool
+ *
+ * Fixed set of persistent worker threads consuming a queue of tasks.
+ * The threads are created once and reused from one call to the other, so that dispatching
+ * work at every decision does not pay the thread creation cost.
+ * Several threads may submit work to the same pool concurrently.
+ * The pool is neither copyable nor movable, hold it through a pointer.
+ */
+class thread_pool {
+public:
+    std::vector<std::thread> threads; ///< Worker threads
+    std::deque<std::function<void()>> tasks; ///< Queued tasks
+    std::mutex mutex; ///< Protects the queue and the counters
+    std::condition_variable task_available; ///< Signalled when a task is queued or the pool stops
+    std::condition_variable all_done; ///< Signalled when the last pending task is over
+    unsigned nb_pending; ///< Number of queued or running tasks
+    bool is_stopping; ///< Set to true by the destructor
+
+    /**
+     * @brief Constructor
+     *
+     * @param {unsigned} nb_threads; number of worker threads
+     */
+    thread_pool(unsigned nb_threads) : nb_pending(0), is_stopping(false) {
+        for(unsigned i=0; i<nb_threads; ++i) {
+            threads.emplace_back([this]() { work(); });
+        }
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    /**
+     * @brief Destructor
+     *
+     * Wait for the pending tasks then join the threads.
+     */
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            is_stopping = true;
+        }
+        task_available.notify_all();
+        for(auto &t : threads) {
+            t.join();
+        }
+    }
+
+    /**
+     * @brief Work
+     *
+     * Loop of a worker thread: pop and run tasks until the pool stops.
+     */
+    void work() {
+        for(;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                task_available.wait(lock, [this]() { return is_stopping || !tasks.empty(); });
+                if(tasks.empty()) { // stopping and nothing left to do
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+            std::lock_guard<std::mutex> lock(mutex);
+            if(--nb_pending == 0) {
+                all_done.notify_all();
+            }
+        }
+    }
+
+    /**
+     * @brief Submit
+     *
+     * Queue a task, which must not throw.
+     * @param {std::function<void()>} task; task
+     */
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+            ++nb_pending;
+        }
+        task_available.notify_one();
+    }
+
+    /**
+     * @brief Wait
+     *
+     * Block until every submitted task is over.
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        all_done.wait(lock, [this]() { return nb_pending == 0; });
+    }
+
+    /**
+     * @brief Parallel for
+     *
+     * Call f(i) for i in [0, n) and block until every call is over.
+     * The calling thread runs f(0) itself while the worker threads run the other calls,
+     * hence n calls keep a pool of n - 1 threads busy.
+     * Only the calls of this batch are waited for.
+     * @param {unsigned} n; number of calls
+     * @param {F} f; function taking an unsigned indice
+     */
+    template <class F>
+    void parallel_for(unsigned n, F f) {
+        if(n == 0) {
+            return;
+        }
+        std::mutex batch_mutex;
+        std::condition_variable batch_done;
+        unsigned nb_remaining = n - 1;
+        for(unsigned i=1; i<n; ++i) {
+            submit([&,i]() {
+                f(i);
+                std::lock_guard<std::mutex> lock(batch_mutex);
+                if(--nb_remaining == 0) {
+                    batch_done.notify_all();
+                }
+            });
+        }
+        f(0);
+        std::unique_lock<std::mutex> lock(batch_mutex);
+        batch_done.wait(lock, [&]() { return nb_remaining == 0; });
+    }
+
+    /**
+     * @brief Seeded parallel for
+     *
+     * Same as 'parallel_for' but each call runs with its own random stream, hence the
+     * results are reproducible for a given seed whatever the scheduling of the calls.
+     * The seeds are the outputs of a splitmix64 sequence started from a single draw of the
+     * stream of the calling thread, consecutive outputs of the latter being consecutive
+     * states of a same stream; apart from this draw, the stream of the calling thread,
+     * which runs the first call, is restored afterwards.
+     * @param {unsigned} n; number of calls
+     * @param {F} f; function taking an unsigned indice
+     */
+    template <class F>
+    void seeded_parallel_for(unsigned n, F f) {
+        std::uint64_t base = rand_unsigned();
+        std::vector<unsigned> seeds(n);
+        for(unsigned i=0; i<n; ++i) {
+            seeds[i] = static_cast<unsigned>(hash_mix(base + (i + 1) * 0x9e3779b97f4a7c15ULL) >> 32);
+        }
+        std::minstd_rand caller_engine = random_engine();
+        parallel_for(n,[&](unsigned i) {
+            seed_random_engine(seeds[i]);
+            f(i);
+        });
+        random_engine() = caller_engine;
+    }
+};
+
+#endif // THREAD_POOL_HPP_
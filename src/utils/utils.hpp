@@ -1,6 +1,10 @@
 #ifndef UTILS_HPP_
 #define UTILS_HPP_
 
+#include <cstdint>
+#include <limits>
+#include <memory>
+
 constexpr double COMPARISON_THRESHOLD = 1e-10;
 
 /**
@@ -82,6 +86,56 @@ double sign(T x) {
     return (is_less_than(x,0.)) ? -1. : 1.;
 }
 
+/**
+ * @brief Random engine
+ *
+ * Pseudo-random generator of the calling thread.
+ * Each thread has its own stream, seeded with 'rand()' at the first use in the thread so
+ * that 'srand' still drives the sequential runs; see 'seed_random_engine' to give a
+ * thread a reproducible stream.
+ * @return Return a reference to the generator of the calling thread.
+ */
+inline std::minstd_rand &random_engine() {
+    thread_local std::minstd_rand engine(rand());
+    return engine;
+}
+
+/**
+ * @brief Hash mix
+ *
+ * Finalizer of the splitmix64 generator, used to scramble hash values.
+ * @param {std::uint64_t} h; input value
+ * @return Return the scrambled value.
+ */
+inline std::uint64_t hash_mix(std::uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+/**
+ * @brief Seed random engine
+ *
+ * Seed the pseudo-random generator of the calling thread.
+ * @param {unsigned} seed; seed
+ */
+inline void seed_random_engine(unsigned seed) {
+    random_engine().seed(seed);
+}
+
+/**
+ * @brief Random unsigned
+ *
+ * Thread-safe replacement of 'rand()', drawn from the generator of the calling thread.
+ * @return Return a random integer in [0, 2^31 - 2].
+ */
+inline unsigned rand_unsigned() {
+    return random_engine()();
+}
+
 /**
  * @brief Shuffle
  *
@@ -89,7 +143,9 @@ double sign(T x) {
  */
 template <class T>
 inline void shuffle(std::vector<T> &v) {
-    std::random_shuffle(v.begin(), v.end());
+    for(unsigned i=v.size(); i>1; --i) { // Fisher-Yates, std::random_shuffle is removed in C++17
+        std::swap(v[i-1],v[rand_unsigned() % i]);
+    }
 }
 
 /**
@@ -103,7 +159,7 @@ inline void shuffle(std::vector<T> &v) {
 template <class T>
 inline unsigned rand_indice(const std::vector<T> &v) {
     assert(v.size() != 0);
-    return rand() % v.size();
+    return rand_unsigned() % v.size();
 }
 
 /**
@@ -137,21 +193,98 @@ void remove_elements(std::vector<T> &v, std::vector<unsigned> &indices) {
 }
 
 /**
- * @brief Argmax
+ * @brief Get unshared
  *
- * Get the indice of the maximum element in the input vector, ties are broken arbitrarily.
+ * Copy-on-write access to an object shared by several pointers: the object is copied
+ * first if the input pointer is not its only owner.
  * Template method.
+ * @param {std::shared_ptr<T> &} p; pointer to the object, reset to the copy if any
+ * @return Return a reference to the object, which the input pointer owns alone.
+ */
+template <class T>
+T & get_unshared(std::shared_ptr<T> &p) {
+    if(p.use_count() > 1) {
+        p = std::make_shared<T>(*p);
+    }
+    return *p;
+}
+
+/**
+ * @brief Argmax of a function
+ *
+ * Get the indice i in [0, n) maximizing f(i) in a single pass, ties are broken uniformly
+ * at random by reservoir sampling, hence no temporary vector is allocated.
+ * Template method.
+ * @param {unsigned} n; number of indices, must be positive
+ * @param {F} f; function taking an indice
+ * @return Return the indice of the maximum value.
+ */
+template <class F>
+inline unsigned argmax_of(unsigned n, F f) {
+    assert(n != 0);
+    auto maxval = f(0);
+    unsigned ind = 0;
+    unsigned nb_ties = 1;
+    for (unsigned j=1; j<n; ++j) {
+        auto val = f(j);
+        if(is_greater_than(val,maxval)) {
+            maxval = val;
+            ind = j;
+            nb_ties = 1;
+        } else if(!is_less_than(val,maxval) && rand_unsigned() % ++nb_ties == 0) {
+            ind = j;
+        }
+    }
+    return ind;
+}
+
+constexpr unsigned ARGMAX_BLOCK_SIZE = 4; ///< Number of values processed together by 'argmax_of_blocks'
+
+/**
+ * @brief Argmax of blocks
+ *
+ * Same as 'argmax_of' for the values of an array padded with -infinity to a multiple of
+ * ARGMAX_BLOCK_SIZE, given their maximum: the ties are counted in a branch-free pass over
+ * blocks of fixed size, which the compiler vectorizes, then a single random draw picks one
+ * of them.
+ * @param {const double *} values; padded values
+ * @param {unsigned} n; number of values, the padding excluded, must be positive
+ * @param {double} maxval; maximum of the values
+ * @return Return the indice of a maximum value.
+ */
+inline unsigned argmax_of_blocks(const double *values, unsigned n, double maxval) {
+    assert(n != 0);
+    double threshold = maxval - COMPARISON_THRESHOLD; // ties as in 'argmax_of'
+    double counts[ARGMAX_BLOCK_SIZE] = {};
+    for(unsigned b=0; b<n; b+=ARGMAX_BLOCK_SIZE) {
+        for(unsigned k=0; k<ARGMAX_BLOCK_SIZE; ++k) {
+            counts[k] += (values[b + k] < threshold) ? 0. : 1.;
+        }
+    }
+    double nb_ties = 0.;
+    for(unsigned k=0; k<ARGMAX_BLOCK_SIZE; ++k) {
+        nb_ties += counts[k];
+    }
+    unsigned rank = (nb_ties > 0.) ? rand_unsigned() % ((unsigned) nb_ties) : 0;
+    for(unsigned i=0; i<n; ++i) {
+        if(!(values[i] < threshold) && rank-- == 0) {
+            return i;
+        }
+    }
+    return 0; // the padding is tied with the maximum, i.e. no value is above -infinity
+}
+
+/**
+ * @brief Argmax
+ *
+ * Get the indice of the maximum element in the input vector, ties are broken uniformly at
+ * random. Template method.
  * @param {const std::vector<T> &} v; input vector
  * @return Return the indice of the maximum element in the input vector.
  */
 template <class T>
 inline unsigned argmax(const std::vector<T> &v) {
-    auto maxval = *std::max_element(v.begin(),v.end());
-    std::vector<unsigned> up_ind;
-    for (unsigned j=0; j<v.size(); ++j) {
-        if(!is_less_than(v[j],maxval)) {up_ind.push_back(j);}
-    }
-    return rand_element(up_ind);
+    return argmax_of(v.size(),[&](unsigned j) {return v[j];});
 }
 
 /**
@@ -161,51 +294,93 @@ inline unsigned argmax(const std::vector<T> &v) {
  */
 template <class T>
 inline unsigned argmin(const std::vector<T> &v) {
-    auto minval = *std::min_element(v.begin(),v.end());
-    std::vector<unsigned> lo_ind;
-    for (unsigned j=0; j<v.size(); ++j) {
-        if(!is_greater_than(v[j],minval)) {lo_ind.push_back(j);}
+    return argmax_of(v.size(),[&](unsigned j) {return -v[j];});
+}
+
+/**
+ * @brief Number of halving rounds
+ *
+ * Number of rounds of a sequential halving over the given number of arms, i.e. the number
+ * of times the arms are halved, rounding up, until a single one remains.
+ * @param {unsigned} nb_arms; number of arms
+ * @return Return ceil(log2(nb_arms)), 0 if there is at most one arm.
+ */
+inline unsigned nb_halving_rounds(unsigned nb_arms) {
+    unsigned nb_rounds = 0;
+    for(unsigned n = 1; n < nb_arms; n *= 2) {
+        ++nb_rounds;
     }
-    return rand_element(lo_ind);
+    return nb_rounds;
+}
+
+/**
+ * @brief Halve arms
+ *
+ * End of a round of sequential halving: the arms of lowest value are dropped, the best
+ * half, rounded up, being kept. Template method.
+ * @param {std::vector<T> &} arms; remaining arms, halved
+ * @param {F} value; function taking an arm and returning its value
+ */
+template <class T, class F>
+inline void halve_arms(std::vector<T> &arms, F value) {
+    std::sort(arms.begin(),arms.end(),[&](const T &a, const T &b) {
+        return value(a) > value(b);
+    });
+    arms.resize((arms.size() + 1) / 2);
+}
+
+constexpr unsigned INVERSE_SQRT_TABLE_SIZE = 4096; ///< Size of the table of 'inverse_sqrt', 32KB
+
+/**
+ * @brief Inverse square root
+ *
+ * 1/sqrt(n), read from a precomputed table for the small values of n, which are the
+ * visit counts of most of the nodes of a search tree.
+ * @param {unsigned} n; input value
+ * @return Return 1/sqrt(n), +infinity for n = 0.
+ */
+inline double inverse_sqrt(unsigned n) {
+    static const std::vector<double> table = []() {
+        std::vector<double> t(INVERSE_SQRT_TABLE_SIZE,std::numeric_limits<double>::infinity());
+        for(unsigned i=1; i<INVERSE_SQRT_TABLE_SIZE; ++i) {
+            t[i] = 1. / std::sqrt((double) i);
+        }
+        return t;
+    }();
+    return (n < INVERSE_SQRT_TABLE_SIZE) ? table[n] : 1. / std::sqrt((double) n);
 }
 
 /**
  * @brief Uniformly distributed integer
  *
- * Generate a uniformly distributed integer.
+ * Generate a uniformly distributed integer with the generator of the calling thread.
  * @return Return the sample.
  */
 int uniform_integer(int int_min, int int_max) {
-    std::random_device rd;
-    std::default_random_engine generator(rd());
     std::uniform_int_distribution<int> distribution(int_min,int_max);
-    return distribution(generator);
+    return distribution(random_engine());
 }
 
 /**
  * @brief Uniformly distributed double
  *
- * Generate a uniformly distributed double.
+ * Generate a uniformly distributed double with the generator of the calling thread.
  * @return Return the sample.
  */
 double uniform_double(double double_min, double double_max) {
-    std::random_device rd;
-    std::default_random_engine generator(rd());
     std::uniform_real_distribution<double> distribution(double_min,double_max);
-    return distribution(generator);
+    return distribution(random_engine());
 }
 
 /**
  * @brief Normally distributed double
  *
- * Generate a normally distributed double.
+ * Generate a normally distributed double with the generator of the calling thread.
  * @return Return the sample.
  */
 double normal_double(double mean, double stddev) {
-    std::random_device rd;
-    std::default_random_engine generator(rd());
     std::normal_distribution<double> distribution(mean,stddev);
-    return distribution(generator);
+    return distribution(random_engine());
 }
 
 /**